@@ -0,0 +1,50 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verificação de alocações no loop do jogo (só com -DALLOC_GUARD)
+// malloc/calloc/realloc chamados pelo código do jogo passam a ser contados. Entre AllocGuardBegin e
+// AllocGuardEnd (o corpo do loop de frames) nenhuma alocação é permitida: a primeira encontrada é impressa
+// com arquivo e linha e o programa é abortado. Sem a flag as duas chamadas não fazem nada.
+// Precisa ser o primeiro include do jogo: os headers do sistema têm que vir antes das macros.
+#ifdef ALLOC_GUARD
+typedef struct allocGuard {
+    bool isArmed;
+    int numAllocs; // Total desde o início do programa
+} AllocGuard;
+
+static AllocGuard allocGuard;
+
+void AllocGuardCheck(const char *function, const char *file, int line) {
+    allocGuard.numAllocs++;
+    if (!allocGuard.isArmed) return;
+    fprintf(stderr, "ALLOC_GUARD: %s dentro do loop do jogo em %s:%d\n", function, file, line);
+    abort();
+}
+
+void *GuardedMalloc(size_t size, const char *file, int line) {
+    AllocGuardCheck("malloc", file, line);
+    return malloc(size);
+}
+
+void *GuardedCalloc(size_t count, size_t size, const char *file, int line) {
+    AllocGuardCheck("calloc", file, line);
+    return calloc(count, size);
+}
+
+void *GuardedRealloc(void *ptr, size_t size, const char *file, int line) {
+    AllocGuardCheck("realloc", file, line);
+    return realloc(ptr, size);
+}
+
+#define malloc(size) GuardedMalloc(size, __FILE__, __LINE__)
+#define calloc(count, size) GuardedCalloc(count, size, __FILE__, __LINE__)
+#define realloc(ptr, size) GuardedRealloc(ptr, size, __FILE__, __LINE__)
+
+void AllocGuardBegin(void) { allocGuard.isArmed = true; }
+void AllocGuardEnd(void) { allocGuard.isArmed = false; }
+#else
+void AllocGuardBegin(void) { }
+void AllocGuardEnd(void) { }
+#endif
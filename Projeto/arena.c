@@ -0,0 +1,60 @@
+#include <stdlib.h>
+#include <string.h>
+
+// Arena da partida
+// Um bloco só, alocado na primeira partida, de onde saem todas as pools e arrays que vivem uma partida
+// (objetos, partículas, broadphase, backgrounds). Alocar é avançar um offset; no fim da partida ArenaReset
+// volta o offset para o início e a memória é reaproveitada pela próxima, sem nenhum free individual.
+// Quem usa a arena não guarda nada entre partidas e não chama free nos ponteiros dela.
+#define arenaAlignment 16
+
+typedef struct arena {
+    char *base;
+    size_t capacity;
+    size_t used;
+    size_t last; // Offset da última alocação (a única que pode crescer no lugar)
+    size_t highWater; // Maior uso já visto, para dimensionar a capacidade
+} Arena;
+
+bool ArenaCreate(Arena *arena, size_t capacity) {
+    arena->base = (char *)malloc(capacity);
+    arena->capacity = (arena->base != NULL ? capacity : 0);
+    arena->used = 0;
+    arena->last = 0;
+    arena->highWater = 0;
+    return arena->base != NULL;
+}
+
+void ArenaDestroy(Arena *arena) {
+    free(arena->base);
+    memset(arena, 0, sizeof(Arena));
+}
+
+// Memória zerada e alinhada, ou NULL se a arena estiver cheia
+void *ArenaAlloc(Arena *arena, size_t size) {
+    size_t offset = (arena->used + arenaAlignment - 1) & ~(size_t)(arenaAlignment - 1);
+    if (offset + size > arena->capacity) return NULL;
+    arena->last = offset;
+    arena->used = offset + size;
+    if (arena->used > arena->highWater) arena->highWater = arena->used;
+    memset(arena->base + offset, 0, size);
+    return arena->base + offset;
+}
+
+// Como realloc: a última alocação cresce no lugar, as outras são copiadas para o fim (o espaço antigo só volta no reset)
+void *ArenaGrow(Arena *arena, void *ptr, size_t oldSize, size_t newSize) {
+    if (ptr == arena->base + arena->last && arena->last + newSize <= arena->capacity) {
+        arena->used = arena->last + newSize;
+        if (arena->used > arena->highWater) arena->highWater = arena->used;
+        return ptr;
+    }
+    void *newPtr = ArenaAlloc(arena, newSize);
+    if (newPtr != NULL) memcpy(newPtr, ptr, oldSize);
+    return newPtr;
+}
+
+// O(1): tudo que foi alocado desde o ArenaCreate deixa de ser válido
+void ArenaReset(Arena *arena) {
+    arena->used = 0;
+    arena->last = 0;
+}
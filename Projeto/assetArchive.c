@@ -0,0 +1,133 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Arquivo de assets empacotado (resources/assets.pak, gerado pelo assetPacker.c)
+// Um cabeçalho, um diretório com uma entrada por arquivo original e os dados já decodificados: pixels no
+// formato que a GPU recebe e amostras PCM. O jogo mapeia o arquivo inteiro na memória e monta Image/Wave
+// apontando direto para os dados, sem copiar nem decodificar PNG/OGG. Sem o arquivo, tudo continua sendo
+// carregado dos arquivos soltos em resources/.
+#define assetArchiveMagic 0x4B504A50 // "PJPK"
+#define assetArchiveVersion 1
+#define assetArchiveAlignment 16 // Início de cada bloco de dados
+#define assetArchivePathLength 128
+
+enum ARCHIVE_ENTRY_KIND {ARCHIVE_IMAGE, ARCHIVE_WAVE};
+
+typedef struct archiveHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numEntries;
+    uint32_t directoryOffset;
+} ArchiveHeader;
+
+typedef struct archiveEntry {
+    char path[assetArchivePathLength]; // Caminho original, do jeito que o jogo pede
+    uint32_t kind;
+    uint32_t offset;
+    uint32_t size;
+    // Imagem: largura, altura, mipmaps, formato. Wave: sampleCount, sampleRate, sampleSize, canais
+    uint32_t params[4];
+} ArchiveEntry;
+
+typedef struct assetArchive {
+    unsigned char *data;
+    size_t size;
+    bool isMapped; // false: arquivo lido para um buffer (sem mmap)
+    const ArchiveEntry *entries;
+    int numEntries;
+} AssetArchive;
+
+static AssetArchive assetArchive;
+
+void CloseAssetArchive(void) {
+    if (assetArchive.data == NULL) return;
+#ifndef _WIN32
+    if (assetArchive.isMapped) munmap(assetArchive.data, assetArchive.size);
+    else free(assetArchive.data);
+#else
+    free(assetArchive.data);
+#endif
+    memset(&assetArchive, 0, sizeof(AssetArchive));
+}
+
+// Devolve false se o arquivo não existir ou não for um pacote válido desta versão
+bool OpenAssetArchive(const char *path) {
+    CloseAssetArchive();
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return false;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            assetArchive.data = (unsigned char *)data;
+            assetArchive.size = info.st_size;
+            assetArchive.isMapped = true;
+        }
+    }
+    close(fd); // O mapeamento continua válido sem o descritor
+#else
+    // Sem mmap no Windows (windows.h conflita com o raylib): uma leitura só do arquivo inteiro
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return false;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size > 0) {
+        assetArchive.data = (unsigned char *)malloc(size);
+        if (assetArchive.data != NULL && fread(assetArchive.data, 1, size, file) == (size_t)size) assetArchive.size = size;
+        else {
+            free(assetArchive.data);
+            assetArchive.data = NULL;
+        }
+    }
+    fclose(file);
+#endif
+    if (assetArchive.data == NULL) return false;
+
+    const ArchiveHeader *header = (const ArchiveHeader *)assetArchive.data;
+    if (assetArchive.size < sizeof(ArchiveHeader) || header->magic != assetArchiveMagic || header->version != assetArchiveVersion ||
+        header->directoryOffset + (size_t)header->numEntries*sizeof(ArchiveEntry) > assetArchive.size) {
+        CloseAssetArchive();
+        return false;
+    }
+    assetArchive.entries = (const ArchiveEntry *)(assetArchive.data + header->directoryOffset);
+    assetArchive.numEntries = header->numEntries;
+    return true;
+}
+
+const ArchiveEntry *FindArchiveEntry(const char *path, enum ARCHIVE_ENTRY_KIND kind) {
+    for (int i = 0; i < assetArchive.numEntries; i++) {
+        const ArchiveEntry *entry = &assetArchive.entries[i];
+        if (entry->kind == kind && strncmp(entry->path, path, assetArchivePathLength) == 0) {
+            if ((size_t)entry->offset + entry->size > assetArchive.size) return NULL;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// A imagem aponta para dentro do arquivo mapeado: só leitura e nunca passar para UnloadImage
+bool ArchiveImage(const char *path, Image *image) {
+    const ArchiveEntry *entry = FindArchiveEntry(path, ARCHIVE_IMAGE);
+    if (entry == NULL) return false;
+    *image = (Image) {assetArchive.data + entry->offset, entry->params[0], entry->params[1], entry->params[2], entry->params[3]};
+    return true;
+}
+
+// Mesmas regras do ArchiveImage
+bool ArchiveWave(const char *path, Wave *wave) {
+    const ArchiveEntry *entry = FindArchiveEntry(path, ARCHIVE_WAVE);
+    if (entry == NULL) return false;
+    *wave = (Wave) {entry->params[0], entry->params[1], entry->params[2], entry->params[3], assetArchive.data + entry->offset};
+    return true;
+}
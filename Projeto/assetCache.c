@@ -0,0 +1,328 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Cache de assets (texturas e sons)
+// Cada arquivo é carregado uma única vez: pedir o mesmo caminho de novo devolve o mesmo handle e só aumenta
+// a contagem de referências. O asset é descarregado quando a última referência é devolvida.
+// Os tamanhos ficam guardados para o relatório de memória no fim do carregamento.
+#define assetCacheCapacity 32
+#define assetPathLength 128
+
+typedef struct cachedTexture {
+    char path[assetPathLength];
+    Texture2D texture;
+    int refCount;
+    size_t bytes; // Memória de vídeo estimada (sem mipmaps extras)
+} CachedTexture;
+
+typedef struct cachedSound {
+    char path[assetPathLength];
+    Sound sound;
+    int refCount;
+    size_t bytes; // Amostras já decodificadas
+} CachedSound;
+
+typedef struct assetCache {
+    CachedTexture textures[assetCacheCapacity];
+    int numTextures;
+    CachedSound sounds[assetCacheCapacity];
+    int numSounds;
+    int numRequests; // Pedidos de asset, contando os que já estavam carregados
+    double loadTime; // s gasto nos carregamentos de verdade
+} AssetCache;
+
+static AssetCache assetCache;
+
+// Guarda a textura no cache com uma referência (NULL se o cache estiver cheio: quem pediu descarrega)
+CachedTexture *CacheTexture(const char *path, Texture2D texture) {
+    if (assetCache.numTextures == assetCacheCapacity) return NULL;
+    CachedTexture *cached = &assetCache.textures[assetCache.numTextures++];
+    strncpy(cached->path, path, assetPathLength - 1);
+    cached->texture = texture;
+    cached->refCount = 1;
+    cached->bytes = (size_t)GetPixelDataSize(texture.width, texture.height, texture.format);
+    return cached;
+}
+
+CachedTexture *FindCachedTexture(const char *path) {
+    for (int i = 0; i < assetCache.numTextures; i++) {
+        CachedTexture *cached = &assetCache.textures[i];
+        if (cached->refCount > 0 && strcmp(cached->path, path) == 0) return cached;
+    }
+    return NULL;
+}
+
+Texture2D AcquireTexture(const char *path) {
+    assetCache.numRequests++;
+    CachedTexture *cached = FindCachedTexture(path);
+    if (cached != NULL) {
+        cached->refCount++;
+        return cached->texture;
+    }
+
+    double start = GetTime();
+    Image image;
+    Texture2D texture = ArchiveImage(path, &image) ? LoadTextureFromImage(image) : LoadTexture(path);
+    assetCache.loadTime += GetTime() - start;
+    CacheTexture(path, texture);
+    return texture;
+}
+
+void ReleaseTexture(Texture2D texture) {
+    for (int i = 0; i < assetCache.numTextures; i++) {
+        CachedTexture *cached = &assetCache.textures[i];
+        if (cached->refCount > 0 && cached->texture.id == texture.id) {
+            if (--cached->refCount == 0) UnloadTexture(cached->texture);
+            return;
+        }
+    }
+    UnloadTexture(texture);
+}
+
+CachedSound *CacheSound(const char *path, Sound sound) {
+    if (assetCache.numSounds == assetCacheCapacity) return NULL;
+    CachedSound *cached = &assetCache.sounds[assetCache.numSounds++];
+    strncpy(cached->path, path, assetPathLength - 1);
+    cached->sound = sound;
+    cached->refCount = 1;
+    cached->bytes = (size_t)sound.sampleCount*(sound.stream.sampleSize/8); // sampleCount já conta os canais
+    return cached;
+}
+
+CachedSound *FindCachedSound(const char *path) {
+    for (int i = 0; i < assetCache.numSounds; i++) {
+        CachedSound *cached = &assetCache.sounds[i];
+        if (cached->refCount > 0 && strcmp(cached->path, path) == 0) return cached;
+    }
+    return NULL;
+}
+
+Sound AcquireSound(const char *path) {
+    assetCache.numRequests++;
+    CachedSound *cached = FindCachedSound(path);
+    if (cached != NULL) {
+        cached->refCount++;
+        return cached->sound;
+    }
+
+    double start = GetTime();
+    Wave wave;
+    Sound sound = ArchiveWave(path, &wave) ? LoadSoundFromWave(wave) : LoadSound(path);
+    assetCache.loadTime += GetTime() - start;
+    CacheSound(path, sound);
+    return sound;
+}
+
+// O som é identificado pelo buffer interno (Sound não tem id)
+void ReleaseSound(Sound sound) {
+    for (int i = 0; i < assetCache.numSounds; i++) {
+        CachedSound *cached = &assetCache.sounds[i];
+        if (cached->refCount > 0 && cached->sound.stream.buffer == sound.stream.buffer) {
+            if (--cached->refCount == 0) UnloadSound(cached->sound);
+            return;
+        }
+    }
+    UnloadSound(sound);
+}
+
+// Resumo do que está carregado, no log do raylib
+void AssetCacheReport(void) {
+    size_t textureBytes = 0, soundBytes = 0;
+    int numTextures = 0, numSounds = 0;
+    for (int i = 0; i < assetCache.numTextures; i++) {
+        if (assetCache.textures[i].refCount == 0) continue;
+        textureBytes += assetCache.textures[i].bytes;
+        numTextures++;
+    }
+    for (int i = 0; i < assetCache.numSounds; i++) {
+        if (assetCache.sounds[i].refCount == 0) continue;
+        soundBytes += assetCache.sounds[i].bytes;
+        numSounds++;
+    }
+    TraceLog(LOG_INFO, "ASSETS: %d pedidos, %d texturas (%.1f MB de vídeo), %d sons (%.1f MB), %.0f ms carregando",
+             assetCache.numRequests, numTextures, textureBytes/(1024.0*1024.0), numSounds, soundBytes/(1024.0*1024.0), assetCache.loadTime*1000);
+}
+
+// Carregamento em paralelo
+// QueueTexture/QueueSound só anotam o caminho e onde escrever o handle. Depois do StartAssetLoader, um grupo de
+// threads decodifica os arquivos (LoadImage/LoadWave, só CPU) enquanto a thread principal, a cada frame da tela
+// de carregamento, sobe para a GPU as imagens prontas e registra as waves no dispositivo de áudio (as duas coisas
+// só podem ser feitas na thread que tem o contexto). Caminhos repetidos viram um único arquivo decodificado.
+// Arquivos que estão no assets.pak já nascem decodificados e nem passam pelas threads.
+#define assetLoaderMaxJobs assetCacheCapacity
+#define assetLoaderMaxRequests 64
+#define assetLoaderMaxWorkers 8
+
+enum ASSET_KIND {ASSET_TEXTURE, ASSET_SOUND};
+enum ASSET_JOB_STATE {ASSET_JOB_QUEUED, ASSET_JOB_DECODED, ASSET_JOB_UPLOADED};
+
+typedef struct assetJob {
+    char path[assetPathLength];
+    enum ASSET_KIND kind;
+    enum ASSET_JOB_STATE state;
+    Image image;
+    Wave wave;
+    bool isMapped; // Dados dentro do assets.pak: não descarregar
+    double decodeTime; // s dentro da thread de trabalho
+} AssetJob;
+
+// Um pedido por handle; vários pedidos podem apontar para o mesmo job
+typedef struct assetRequest {
+    int job;
+    Texture2D *texture;
+    Sound *sound;
+} AssetRequest;
+
+typedef struct assetLoader {
+    AssetJob jobs[assetLoaderMaxJobs];
+    int numJobs;
+    AssetRequest requests[assetLoaderMaxRequests];
+    int numRequests;
+    int nextJob; // Próximo job livre para as threads
+    int numUploaded;
+    pthread_t workers[assetLoaderMaxWorkers];
+    int numWorkers;
+    pthread_mutex_t mutex;
+    double startTime;
+} AssetLoader;
+
+static AssetLoader assetLoader;
+
+int QueueAssetJob(const char *path, enum ASSET_KIND kind) {
+    for (int j = 0; j < assetLoader.numJobs; j++) {
+        if (assetLoader.jobs[j].kind == kind && strcmp(assetLoader.jobs[j].path, path) == 0) return j;
+    }
+    if (assetLoader.numJobs == assetLoaderMaxJobs) return -1;
+    AssetJob *job = &assetLoader.jobs[assetLoader.numJobs];
+    memset(job, 0, sizeof(AssetJob));
+    strncpy(job->path, path, assetPathLength - 1);
+    job->kind = kind;
+    if (kind == ASSET_TEXTURE) job->isMapped = ArchiveImage(path, &job->image);
+    else job->isMapped = ArchiveWave(path, &job->wave);
+    if (job->isMapped) job->state = ASSET_JOB_DECODED;
+    return assetLoader.numJobs++;
+}
+
+// O handle só é válido depois que o carregamento terminar. Sem espaço na fila o asset é carregado na hora
+void QueueTexture(const char *path, Texture2D *texture) {
+    int job = FindCachedTexture(path) == NULL ? QueueAssetJob(path, ASSET_TEXTURE) : -1;
+    if (job == -1 || assetLoader.numRequests == assetLoaderMaxRequests) {
+        *texture = AcquireTexture(path);
+        return;
+    }
+    assetLoader.requests[assetLoader.numRequests++] = (AssetRequest) {job, texture, NULL};
+}
+
+void QueueSound(const char *path, Sound *sound) {
+    int job = FindCachedSound(path) == NULL ? QueueAssetJob(path, ASSET_SOUND) : -1;
+    if (job == -1 || assetLoader.numRequests == assetLoaderMaxRequests) {
+        *sound = AcquireSound(path);
+        return;
+    }
+    assetLoader.requests[assetLoader.numRequests++] = (AssetRequest) {job, NULL, sound};
+}
+
+void *AssetLoaderWorker(void *arg) {
+    while (true) {
+        pthread_mutex_lock(&assetLoader.mutex);
+        while (assetLoader.nextJob < assetLoader.numJobs && assetLoader.jobs[assetLoader.nextJob].isMapped) assetLoader.nextJob++;
+        int j = assetLoader.nextJob < assetLoader.numJobs ? assetLoader.nextJob++ : -1;
+        pthread_mutex_unlock(&assetLoader.mutex);
+        if (j == -1) return NULL;
+
+        // Cada job só é tocado por uma thread até ser marcado como decodificado
+        AssetJob *job = &assetLoader.jobs[j];
+        double start = GetTime();
+        Image image = { 0 };
+        Wave wave = { 0 };
+        if (job->kind == ASSET_TEXTURE) image = LoadImage(job->path);
+        else wave = LoadWave(job->path);
+        double decodeTime = GetTime() - start;
+
+        pthread_mutex_lock(&assetLoader.mutex);
+        job->image = image;
+        job->wave = wave;
+        job->decodeTime = decodeTime;
+        job->state = ASSET_JOB_DECODED;
+        pthread_mutex_unlock(&assetLoader.mutex);
+    }
+}
+
+void StartAssetLoader(void) {
+    assetLoader.startTime = GetTime();
+    assetLoader.nextJob = 0;
+    assetLoader.numUploaded = 0;
+    int numToDecode = 0;
+    for (int j = 0; j < assetLoader.numJobs; j++) numToDecode += !assetLoader.jobs[j].isMapped;
+    assetLoader.numWorkers = NumCpuCores();
+    if (assetLoader.numWorkers > assetLoaderMaxWorkers) assetLoader.numWorkers = assetLoaderMaxWorkers;
+    if (assetLoader.numWorkers > numToDecode) assetLoader.numWorkers = numToDecode;
+    pthread_mutex_init(&assetLoader.mutex, NULL);
+    for (int i = 0; i < assetLoader.numWorkers; i++)
+        pthread_create(&assetLoader.workers[i], NULL, AssetLoaderWorker, NULL);
+}
+
+// Fração dos arquivos que já estão prontos para uso (0 a 1)
+float AssetLoaderProgress(void) {
+    return assetLoader.numJobs == 0 ? 1.0f : (float)assetLoader.numUploaded/assetLoader.numJobs;
+}
+
+// Termina os jobs já decodificados na thread principal. Devolve true quando todos os handles pedidos estão prontos
+bool UpdateAssetLoader(void) {
+    for (int j = 0; j < assetLoader.numJobs; j++) {
+        AssetJob *job = &assetLoader.jobs[j];
+        pthread_mutex_lock(&assetLoader.mutex);
+        bool isDecoded = job->state == ASSET_JOB_DECODED;
+        pthread_mutex_unlock(&assetLoader.mutex);
+        if (!isDecoded) continue;
+
+        Texture2D texture = { 0 };
+        Sound sound = { 0 };
+        CachedTexture *cachedTexture = NULL;
+        CachedSound *cachedSound = NULL;
+        if (job->kind == ASSET_TEXTURE) {
+            texture = LoadTextureFromImage(job->image);
+            if (!job->isMapped) UnloadImage(job->image);
+            cachedTexture = CacheTexture(job->path, texture);
+        } else {
+            sound = LoadSoundFromWave(job->wave);
+            if (!job->isMapped) UnloadWave(job->wave);
+            cachedSound = CacheSound(job->path, sound);
+        }
+        job->state = ASSET_JOB_UPLOADED;
+        assetLoader.numUploaded++;
+
+        // CacheTexture/CacheSound já contam uma referência
+        int numRefs = 0;
+        for (int r = 0; r < assetLoader.numRequests; r++) {
+            AssetRequest *request = &assetLoader.requests[r];
+            if (request->job != j) continue;
+            if (request->texture != NULL) *request->texture = texture;
+            if (request->sound != NULL) *request->sound = sound;
+            assetCache.numRequests++;
+            numRefs++;
+        }
+        if (cachedTexture != NULL) cachedTexture->refCount = numRefs;
+        if (cachedSound != NULL) cachedSound->refCount = numRefs;
+    }
+    if (assetLoader.numUploaded < assetLoader.numJobs) return false;
+
+    for (int i = 0; i < assetLoader.numWorkers; i++)
+        pthread_join(assetLoader.workers[i], NULL);
+    pthread_mutex_destroy(&assetLoader.mutex);
+
+    double decodeTime = 0;
+    int numMapped = 0;
+    for (int j = 0; j < assetLoader.numJobs; j++) {
+        decodeTime += assetLoader.jobs[j].decodeTime;
+        numMapped += assetLoader.jobs[j].isMapped;
+    }
+    double wallTime = GetTime() - assetLoader.startTime;
+    assetCache.loadTime += wallTime;
+    TraceLog(LOG_INFO, "ASSETS: %d arquivos (%d do assets.pak) em %d threads, %.0f ms (%.0f ms de decodificação somando as threads)",
+             assetLoader.numJobs, numMapped, assetLoader.numWorkers, wallTime*1000, decodeTime*1000);
+    assetLoader.numJobs = 0;
+    assetLoader.numRequests = 0;
+    return true;
+}
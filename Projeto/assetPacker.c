@@ -0,0 +1,110 @@
+#include "raylib.h"
+#include "assetArchive.c"
+
+// Empacotador do assets.pak (programa separado, não entra no build do jogo)
+//   gcc assetPacker.c -Iraylib -lraylib -o assetPacker
+//   ./assetPacker resources/assets.pak                  empacota os assets que o jogo carrega na inicialização
+//   ./assetPacker resources/assets.pak arquivo1 ...     empacota só os arquivos passados
+// Rodar de dentro de Projeto/: o caminho gravado é o mesmo que o jogo pede ao cache de assets.
+// Imagens são guardadas em RGBA 8 bits (o formato que LoadTextureFromImage sobe direto) e sons em PCM 16 bits.
+// A música (ambience.mp3) fica de fora: ela é tocada em streaming.
+const static char *defaultAssets[] = {
+    "resources/Atlas/hero_atlas_div.png",
+    "resources/Atlas/assassin_atlas_div.png",
+    "resources/Atlas/gunner_atlas_div.png",
+    "resources/Atlas/misc_atlas.png",
+    "resources/Atlas/background_atlas.png",
+    "resources/Atlas/midground_atlas.png",
+    "resources/Atlas/env_props_atlas.png",
+    "resources/Atlas/foreground_atlas.png",
+    "resources/Menu/menu_fundo.png",
+    "resources/Menu/logo.png",
+    "resources/Audio/magnumShot.ogg",
+    "resources/Audio/meleeAtaque.ogg",
+    "resources/Audio/menuSelectionChange.ogg",
+    "resources/Audio/menuSelected.ogg",
+    "resources/Audio/entityLanding.ogg",
+    "resources/Audio/grenadeLaunch.ogg",
+    "resources/Audio/grenadeBouncing.ogg",
+    "resources/Audio/grenadeExplosion.ogg",
+    "resources/Audio/hurt.ogg",
+    "resources/Audio/dying.ogg",
+};
+
+// Escreve os dados alinhados e devolve o offset onde começaram
+uint32_t WriteBlock(FILE *file, const void *data, uint32_t size) {
+    static const unsigned char padding[assetArchiveAlignment] = { 0 };
+    long position = ftell(file);
+    long aligned = (position + assetArchiveAlignment - 1)/assetArchiveAlignment*assetArchiveAlignment;
+    fwrite(padding, 1, aligned - position, file);
+    fwrite(data, 1, size, file);
+    return (uint32_t)aligned;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "uso: %s saida.pak [arquivos...]\n", argv[0]);
+        return 1;
+    }
+    const char **paths = argc > 2 ? (const char **)&argv[2] : defaultAssets;
+    int numPaths = argc > 2 ? argc - 2 : (int)(sizeof(defaultAssets)/sizeof(defaultAssets[0]));
+
+    FILE *file = fopen(argv[1], "wb");
+    if (file == NULL) {
+        fprintf(stderr, "não foi possível criar '%s'\n", argv[1]);
+        return 1;
+    }
+    ArchiveHeader header = {assetArchiveMagic, assetArchiveVersion, 0, 0};
+    fwrite(&header, sizeof(ArchiveHeader), 1, file); // Reescrito no fim, com o diretório
+
+    ArchiveEntry *entries = (ArchiveEntry *)calloc(numPaths, sizeof(ArchiveEntry));
+    int numEntries = 0;
+    for (int i = 0; i < numPaths; i++) {
+        ArchiveEntry *entry = &entries[numEntries];
+        if (strlen(paths[i]) >= assetArchivePathLength) {
+            fprintf(stderr, "caminho longo demais, ignorado: %s\n", paths[i]);
+            continue;
+        }
+        strcpy(entry->path, paths[i]);
+
+        if (IsFileExtension(paths[i], ".png;.jpg;.jpeg;.bmp;.tga")) {
+            Image image = LoadImage(paths[i]);
+            if (image.data == NULL) continue;
+            ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+            entry->kind = ARCHIVE_IMAGE;
+            entry->size = GetPixelDataSize(image.width, image.height, image.format);
+            entry->offset = WriteBlock(file, image.data, entry->size);
+            entry->params[0] = image.width;
+            entry->params[1] = image.height;
+            entry->params[2] = 1;
+            entry->params[3] = image.format;
+            UnloadImage(image);
+        } else if (IsFileExtension(paths[i], ".ogg;.wav;.mp3;.flac")) {
+            Wave wave = LoadWave(paths[i]);
+            if (wave.data == NULL) continue;
+            WaveFormat(&wave, wave.sampleRate, 16, wave.channels);
+            entry->kind = ARCHIVE_WAVE;
+            entry->size = wave.sampleCount*(wave.sampleSize/8); // sampleCount já conta os canais
+            entry->offset = WriteBlock(file, wave.data, entry->size);
+            entry->params[0] = wave.sampleCount;
+            entry->params[1] = wave.sampleRate;
+            entry->params[2] = wave.sampleSize;
+            entry->params[3] = wave.channels;
+            UnloadWave(wave);
+        } else {
+            fprintf(stderr, "tipo de arquivo desconhecido, ignorado: %s\n", paths[i]);
+            continue;
+        }
+        printf("%-48s %8u KB\n", entry->path, entry->size/1024);
+        numEntries++;
+    }
+
+    header.numEntries = numEntries;
+    header.directoryOffset = WriteBlock(file, entries, numEntries*sizeof(ArchiveEntry));
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(ArchiveHeader), 1, file);
+    fclose(file);
+    free(entries);
+    printf("%d arquivos em %s\n", numEntries, argv[1]);
+    return 0;
+}
@@ -0,0 +1,306 @@
+// Benchmark da simulação e do desenho, em cima do modo headless.
+// Cada cenário é uma sessão reproduzível (seed + script de entrada + preparação do mundo) e tem o tempo
+// de cada subsistema medido frame a frame. O resultado sai em JSON com p50/p95/p99/max em microssegundos.
+//
+// Compilar:  gcc main.c -O2 -DHEADLESS -DBENCHMARK -Iraylib -o benchmark -lm -pthread
+// Executar:  ./benchmark --out bench.json                  roda os cenários e grava o resultado
+//            ./benchmark --baseline bench.json             compara com uma execução anterior (sai com 2 se piorou)
+//            ./benchmark --replay partida.rpl              mede uma partida gravada em vez dos cenários
+// Opções:    --tolerance 0.15 (piora relativa aceita no p50/p95), --frames N (frames por cenário)
+#define benchMinRegressionUs 0.5 // Diferenças menores que isso são ruído de medição
+#define benchMaxJsonSize (1 << 20)
+
+// Zonas do profiler + o frame inteiro (passo + desenho)
+#define benchFrameZone NUM_PROFILE_ZONES
+#define benchNumZones (NUM_PROFILE_ZONES + 1)
+
+typedef struct benchScenario {
+    const char *name;
+    uint64_t seed;
+    int frames;
+    const char *script;
+    void (*setup)(World *world);
+    void (*everyFrame)(World *world); // Chamado antes de cada passo, fora da medição
+} BenchScenario;
+
+typedef struct benchResult {
+    const char *name;
+    int frames;
+    double p50[benchNumZones], p95[benchNumZones], p99[benchNumZones], max[benchNumZones]; // us
+    int maxSprites, maxBatches; // Pior frame do batch de sprites (o número de batches deve ficar estável)
+    int maxDropped; // Sprites que não couberam no batch (deve ficar em 0)
+    int maxDrawn, maxCulled; // Pior frame do culling
+    int chunksPlannedOnMainThread; // Chunks que a thread de trabalho não entregou a tempo
+} BenchResult;
+
+// Gerador próprio para não mexer nos streams da simulação
+static Rng benchRng;
+
+int BenchValue(int min, int max) {
+    return min + (int)(((uint64_t)RngNext(&benchRng)*(uint32_t)(max - min + 1)) >> 32);
+}
+
+//------------------------------------------------------------------------------------
+// Cenários
+//------------------------------------------------------------------------------------
+// O player não morre durante a medição
+void BenchKeepPlayerAlive(World *world) {
+    world->player.entity.currentHP = world->player.entity.maxHP;
+}
+
+void BenchSetupLateGame(World *world) {
+    world->time = 5*7*screenWidth/10.0f; // UpdateDifficulty -> dificuldade 5
+}
+
+// Enche a enemyPool com inimigos das classes [minClass, maxClass] caindo na frente da câmera
+void BenchSpawnEnemies(World *world, enum ENEMY_CLASSES minClass, enum ENEMY_CLASSES maxClass) {
+    while (PoolCount(world->enemyPool) < maxNumEnemies) {
+        float x = world->camera.target.x + BenchValue(0, screenWidth);
+        CreateEnemy(world->enemyPool, BenchValue(minClass, maxClass), (Vector2) {x, screenHeight - BenchValue(300, 900)}, 122, 122);
+    }
+}
+
+// Mantém a enemyPool cheia
+void BenchFillEnemies(World *world) {
+    BenchKeepPlayerAlive(world);
+    BenchSpawnEnemies(world, ASSASSIN, GUNNER);
+}
+
+// Só snipers: cada tiro é hitscan (um raio por pool no DispatchEvents, medido em PROF_EVENTS)
+void BenchFillSnipers(World *world) {
+    BenchKeepPlayerAlive(world);
+    BenchSpawnEnemies(world, SNIPERSHOOTER, SNIPERSHOOTER);
+}
+
+// Granadas infinitas e barris explosivos na frente do player, para encadear ExplosionAOE
+void BenchGrenadeSpam(World *world) {
+    BenchKeepPlayerAlive(world);
+    world->player.entity.grenadeAmmo = 99;
+    if ((int)(world->time/fixedTimeStep + 0.5f)%60 == 0) {
+        for (int i = 0; i < 4; i++)
+            CreateEnvProp(world->envPropsPool, world->groundPool, EXPLOSIVE_BARREL, (Vector2) {world->player.entity.position.x + 150 + i*135, screenHeight - 60 - 130}, 130, 130);
+    }
+}
+
+// Particle pool sempre cheia
+void BenchSaturateParticles(World *world) {
+    BenchKeepPlayerAlive(world);
+    while (world->particlePool->count < maxNumParticles) {
+        Vector2 position = {world->camera.target.x + BenchValue(-screenWidth/2, screenWidth/2), BenchValue(0, screenHeight)};
+        Vector2 velocity = {BenchValue(-100, 100), BenchValue(-100, 100)};
+        CreateParticle(position, velocity, world->particlePool, BenchValue(EXPLOSION, SMOKE), 4, BenchValue(-90, 90), (Vector2) {1, 1}, false, 1);
+    }
+}
+
+static const BenchScenario benchScenarios[] = {
+    {"early_game", 11, 3600, NULL, NULL, BenchKeepPlayerAlive},
+    {"late_game_full_enemies", 12, 3600, NULL, BenchSetupLateGame, BenchFillEnemies},
+    {"grenade_spam", 13, 3600, "1 T\n" "11 RIGHT\n" "1 T\n" "11\n", NULL, BenchGrenadeSpam},
+    {"particle_saturation", 14, 3600, NULL, NULL, BenchSaturateParticles},
+    {"hitscan_snipers", 15, 3600, NULL, NULL, BenchFillSnipers},
+};
+#define benchNumScenarios (int)(sizeof(benchScenarios)/sizeof(benchScenarios[0]))
+
+//------------------------------------------------------------------------------------
+// Medição
+//------------------------------------------------------------------------------------
+int BenchCompareFloat(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+double BenchPercentile(const float *sorted, int n, double q) {
+    int i = (int)ceil(q*n) - 1;
+    return sorted[i < 0 ? 0 : (i >= n ? n - 1 : i)];
+}
+
+// Roda uma sessão. Com replay != NULL a entrada e a seed vêm do arquivo e a sessão vai até o fim dele
+BenchResult BenchRun(const BenchScenario *scenario, ReplayReader *replay, int maxFrames, Sound *fxSoundPool) {
+    BenchResult result = {scenario->name, 0};
+    Texture2D empty = {0};
+    // Sem GPU as texturas só precisam de ids diferentes, para o batch de sprites agrupar como no jogo
+    Texture2D characterTex = {1}, miscAtlas = {2}, envPropsAtlas = {3};
+    Texture2D enemyTex[BOSS + 1];
+    for (int i = 0; i <= BOSS; i++) enemyTex[i] = (Texture2D) {4 + i};
+    float *samples = (float *)malloc((size_t)benchNumZones*maxFrames*sizeof(float)); // samples[zona*maxFrames + frame]
+
+    memset(&headlessInput, 0, sizeof(headlessInput));
+    HeadlessParseScript(&headlessInput, scenario->script != NULL ? scenario->script : headlessDefaultScript);
+    RngSeedStream(&benchRng, scenario->seed);
+
+    World world = {0};
+    InitWorld(&world, empty, empty, empty, fxSoundPool, replay != NULL ? replay->seed : scenario->seed);
+    world.playback = replay;
+    if (scenario->setup != NULL) scenario->setup(&world);
+
+    int frame = 0;
+    for (; frame < maxFrames; frame++) {
+        HeadlessUpdateInput(&headlessInput);
+        if (scenario->everyFrame != NULL) scenario->everyFrame(&world);
+
+        ProfileBeginFrame();
+        double start = GetTime();
+        if (StepWorld(&world, fixedTimeStep, ReadKeyboardInput()) == 0) break; // Fim do replay
+        DrawWorld(&world, characterTex, miscAtlas, envPropsAtlas, enemyTex);
+        double frameTime = GetTime() - start;
+        ProfileEndFrame();
+        if (spriteBatch.lastNumSprites > result.maxSprites) result.maxSprites = spriteBatch.lastNumSprites;
+        if (spriteBatch.lastNumBatches > result.maxBatches) result.maxBatches = spriteBatch.lastNumBatches;
+        if (spriteBatch.lastNumDropped > result.maxDropped) result.maxDropped = spriteBatch.lastNumDropped;
+        if (world.numDrawn > result.maxDrawn) result.maxDrawn = world.numDrawn;
+        if (world.numCulled > result.maxCulled) result.maxCulled = world.numCulled;
+
+        for (int z = 0; z < NUM_PROFILE_ZONES; z++)
+            samples[z*maxFrames + frame] = profileFrame[z]*1e6;
+        samples[benchFrameZone*maxFrames + frame] = frameTime*1e6;
+        if (replay != NULL && world.player.entity.lowerAnimation.currentAnimationState == DEAD) {
+            frame++;
+            break;
+        }
+    }
+    result.frames = frame;
+
+    for (int z = 0; z < benchNumZones && frame > 0; z++) {
+        float *zone = samples + z*maxFrames;
+        qsort(zone, frame, sizeof(float), BenchCompareFloat);
+        result.p50[z] = BenchPercentile(zone, frame, 0.50);
+        result.p95[z] = BenchPercentile(zone, frame, 0.95);
+        result.p99[z] = BenchPercentile(zone, frame, 0.99);
+        result.max[z] = zone[frame - 1];
+    }
+
+    result.chunksPlannedOnMainThread = world.chunkPipeline->numPlannedOnMainThread;
+    UnloadWorld(&world); // Também fecha o replay
+    ArenaDestroy(&world.arena);
+    free(samples);
+    return result;
+}
+
+const char *BenchZoneName(int zone) {
+    return zone == benchFrameZone ? "frame" : profileZoneNames[zone];
+}
+
+void BenchWriteJson(FILE *file, BenchResult *results, int numResults) {
+    fprintf(file, "{\n  \"unit\": \"us\",\n  \"scenarios\": [\n");
+    for (int s = 0; s < numResults; s++) {
+        fprintf(file, "    {\n      \"name\": \"%s\",\n      \"frames\": %d,\n      \"max_sprites\": %d,\n      \"max_batches\": %d,\n      \"max_dropped\": %d,\n      \"max_drawn\": %d,\n      \"max_culled\": %d,\n      \"chunks_planned_on_main_thread\": %d,\n      \"zones\": {\n",
+                results[s].name, results[s].frames, results[s].maxSprites, results[s].maxBatches, results[s].maxDropped, results[s].maxDrawn, results[s].maxCulled, results[s].chunksPlannedOnMainThread);
+        for (int z = 0; z < benchNumZones; z++) {
+            fprintf(file, "        \"%s\": {\"p50_us\": %.3f, \"p95_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f}%s\n", BenchZoneName(z),
+                    results[s].p50[z], results[s].p95[z], results[s].p99[z], results[s].max[z], z + 1 < benchNumZones ? "," : "");
+        }
+        fprintf(file, "      }\n    }%s\n", s + 1 < numResults ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+//------------------------------------------------------------------------------------
+// Comparação com o baseline
+//------------------------------------------------------------------------------------
+// Lê do JSON de uma execução anterior os percentis de uma zona de um cenário. Só entende o formato do BenchWriteJson
+bool BenchFindBaseline(const char *json, const char *scenario, const char *zone, double *p50, double *p95) {
+    char key[128];
+    snprintf(key, sizeof(key), "\"name\": \"%s\"", scenario);
+    const char *begin = strstr(json, key);
+    if (begin == NULL) return false;
+    const char *end = strstr(begin + 1, "\"name\":");
+
+    snprintf(key, sizeof(key), "\"%s\": {", zone);
+    const char *entry = strstr(begin, key);
+    if (entry == NULL || (end != NULL && entry > end)) return false;
+    return sscanf(entry + strlen(key), "\"p50_us\": %lf, \"p95_us\": %lf", p50, p95) == 2;
+}
+
+// Retorna quantas métricas pioraram além da tolerância
+int BenchCompare(BenchResult *results, int numResults, const char *baselineFile, double tolerance) {
+    FILE *file = fopen(baselineFile, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "benchmark: não foi possível ler o baseline '%s'\n", baselineFile);
+        return -1;
+    }
+    char *json = (char *)malloc(benchMaxJsonSize);
+    size_t size = fread(json, 1, benchMaxJsonSize - 1, file);
+    json[size] = '\0';
+    fclose(file);
+
+    int regressions = 0;
+    for (int s = 0; s < numResults; s++) {
+        for (int z = 0; z < benchNumZones; z++) {
+            double baseP50, baseP95;
+            if (!BenchFindBaseline(json, results[s].name, BenchZoneName(z), &baseP50, &baseP95)) continue;
+
+            double cur[2] = {results[s].p50[z], results[s].p95[z]}, base[2] = {baseP50, baseP95};
+            const char *label[2] = {"p50", "p95"};
+            for (int k = 0; k < 2; k++) {
+                if (cur[k] > base[k]*(1 + tolerance) && cur[k] - base[k] > benchMinRegressionUs) {
+                    fprintf(stderr, "REGRESSÃO %s/%s %s: %.3f us -> %.3f us (%+.0f%%)\n", results[s].name, BenchZoneName(z), label[k],
+                            base[k], cur[k], base[k] > 0 ? 100*(cur[k]/base[k] - 1) : 100.0);
+                    regressions++;
+                }
+            }
+        }
+    }
+    free(json);
+    return regressions;
+}
+
+//------------------------------------------------------------------------------------
+// Programa principal
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+    const char *outFile = NULL;
+    const char *baselineFile = NULL;
+    const char *replayFile = NULL;
+    double tolerance = 0.15;
+    int frames = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) outFile = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baselineFile = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayFile = argv[++i];
+        else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = atof(argv[++i]);
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) frames = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "uso: %s [--out arquivo] [--baseline arquivo] [--tolerance T] [--frames N] [--replay arquivo]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Sound *fxSoundPool = (Sound *)calloc(10, sizeof(Sound));
+    BenchResult results[benchNumScenarios];
+    int numResults = 0;
+    ProfileSetEnabled(true);
+    JobSystemInit(0);
+
+    if (replayFile != NULL) {
+        ReplayReader *replay = ReplayOpenReader(replayFile);
+        if (replay == NULL) {
+            fprintf(stderr, "benchmark: não foi possível abrir o replay '%s'\n", replayFile);
+            return 1;
+        }
+        int maxFrames = (frames > 0 ? frames : (replay->numTicks > 0 ? (int)replay->numTicks : 36000));
+        BenchScenario scenario = {"replay", 0, maxFrames, NULL, NULL, NULL};
+        results[numResults++] = BenchRun(&scenario, replay, maxFrames, fxSoundPool);
+    } else {
+        for (int s = 0; s < benchNumScenarios; s++)
+            results[numResults++] = BenchRun(&benchScenarios[s], NULL, frames > 0 ? frames : benchScenarios[s].frames, fxSoundPool);
+    }
+
+    FILE *out = (outFile != NULL ? fopen(outFile, "wb") : stdout);
+    if (out == NULL) {
+        fprintf(stderr, "benchmark: não foi possível criar '%s'\n", outFile);
+        return 1;
+    }
+    BenchWriteJson(out, results, numResults);
+    if (out != stdout) fclose(out);
+
+    int regressions = 0;
+    if (baselineFile != NULL) {
+        regressions = BenchCompare(results, numResults, baselineFile, tolerance);
+        if (regressions == 0) fprintf(stderr, "benchmark: sem regressões em relação a '%s'\n", baselineFile);
+    }
+    JobSystemShutdown();
+    UnloadRenderTexturePool();
+    free(fxSoundPool);
+    return (regressions > 0 ? 2 : (regressions < 0 ? 1 : 0));
+}
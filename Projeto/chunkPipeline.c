@@ -0,0 +1,223 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Geração de chunks em segundo plano
+// Um chunk é planejado (PlanChunk) sem tocar no mundo nem na GPU: o plano guarda os comandos de desenho do
+// canvas, as plataformas, os props e as tentativas de inimigo. Como o plano só depende da seed, da camada e do
+// índice do chunk, uma thread de trabalho prepara os próximos chunkPipelineDepth chunks de cada camada enquanto
+// o jogo roda. Na troca de chunk a thread principal só cria os objetos do plano (CommitChunk) e usa o canvas,
+// que normalmente já foi desenhado alguns passos antes. Se o plano ainda não estiver pronto, a thread principal
+// planeja na hora (mesmo resultado, só mais lento).
+#define chunkPipelineDepth 3
+#define chunkNumLayers 3
+#define chunkMaxCommands 512
+#define chunkMaxGrounds 64
+#define chunkMaxProps 24
+#define chunkMaxEnemySlots 32 // Uma tentativa por nível de dificuldade, a dificuldade na hora da troca decide quantas valem
+
+typedef struct canvasCommand {
+    Rectangle source;
+    Rectangle dest;
+    Color color;
+    bool isFill; // Retângulo preenchido com color em vez de um recorte do atlas
+} CanvasCommand;
+
+typedef struct chunkProp {
+    int type; // OBJECTS_TYPES
+    Vector2 position;
+    int width, height;
+} ChunkProp;
+
+typedef struct chunkEnemy {
+    bool spawn;
+    int enemyClass; // ENEMY_CLASSES
+    Vector2 position;
+} ChunkEnemy;
+
+typedef struct chunkPlan {
+    int layer; // BACKGROUND_TYPES
+    int chunkId;
+    CanvasCommand commands[chunkMaxCommands];
+    int numCommands;
+    Rectangle grounds[chunkMaxGrounds];
+    int numGrounds;
+    ChunkProp props[chunkMaxProps];
+    int numProps;
+    ChunkEnemy enemies[chunkMaxEnemySlots];
+} ChunkPlan;
+
+enum CHUNK_SLOT_STATE {CHUNK_SLOT_EMPTY, CHUNK_SLOT_QUEUED, CHUNK_SLOT_WORKING, CHUNK_SLOT_READY};
+
+typedef struct chunkSlot {
+    int state; // CHUNK_SLOT_STATE, protegido pelo mutex
+    int chunkId;
+    ChunkPlan plan;
+    bool isPainted; // canvas já desenhado com o plano (só a thread principal mexe)
+    RenderTexture2D canvas;
+} ChunkSlot;
+
+typedef struct chunkPipeline {
+    ChunkSlot slots[chunkNumLayers][chunkPipelineDepth]; // [camada][chunkId % chunkPipelineDepth]
+    pthread_t worker;
+    pthread_mutex_t mutex;
+    pthread_cond_t wake; // Pedido novo ou fim
+    pthread_cond_t done; // Um plano ficou pronto
+    bool quit;
+    int numPlannedOnMainThread; // Trocas em que a thread de trabalho estava atrasada
+} ChunkPipeline;
+
+void PlanChunk(ChunkPlan *plan, int layer, int chunkId);
+
+//------------------------------------------------------------------------------------
+// Montagem do plano (usado pelo PlanChunk)
+//------------------------------------------------------------------------------------
+void PlanDraw(ChunkPlan *plan, Rectangle source, Rectangle dest) {
+    if (plan->numCommands == chunkMaxCommands) return;
+    plan->commands[plan->numCommands++] = (CanvasCommand) {source, dest, WHITE, false};
+}
+
+void PlanFill(ChunkPlan *plan, Rectangle dest, Color color) {
+    if (plan->numCommands == chunkMaxCommands) return;
+    plan->commands[plan->numCommands++] = (CanvasCommand) {{0}, dest, color, true};
+}
+
+void PlanGround(ChunkPlan *plan, Vector2 position, int width, int height) {
+    if (plan->numGrounds == chunkMaxGrounds) return;
+    plan->grounds[plan->numGrounds++] = (Rectangle) {position.x, position.y, width, height};
+}
+
+void PlanProp(ChunkPlan *plan, int type, Vector2 position, int width, int height) {
+    if (plan->numProps == chunkMaxProps) return;
+    plan->props[plan->numProps++] = (ChunkProp) {type, position, width, height};
+}
+
+//------------------------------------------------------------------------------------
+// Thread de trabalho
+//------------------------------------------------------------------------------------
+void *ChunkPipelineWorker(void *arg) {
+    ChunkPipeline *pipeline = (ChunkPipeline *)arg;
+    pthread_mutex_lock(&pipeline->mutex);
+    while (!pipeline->quit) {
+        // Pega o pedido mais próximo da câmera (menor chunkId)
+        ChunkSlot *next = NULL;
+        int nextLayer = 0;
+        for (int l = 0; l < chunkNumLayers; l++) {
+            for (int s = 0; s < chunkPipelineDepth; s++) {
+                ChunkSlot *slot = &pipeline->slots[l][s];
+                if (slot->state == CHUNK_SLOT_QUEUED && (next == NULL || slot->chunkId < next->chunkId)) {
+                    next = slot;
+                    nextLayer = l;
+                }
+            }
+        }
+        if (next == NULL) {
+            pthread_cond_wait(&pipeline->wake, &pipeline->mutex);
+            continue;
+        }
+
+        next->state = CHUNK_SLOT_WORKING;
+        int chunkId = next->chunkId;
+        pthread_mutex_unlock(&pipeline->mutex);
+        PlanChunk(&next->plan, nextLayer, chunkId);
+        pthread_mutex_lock(&pipeline->mutex);
+        next->state = CHUNK_SLOT_READY;
+        pthread_cond_broadcast(&pipeline->done);
+    }
+    pthread_mutex_unlock(&pipeline->mutex);
+    return NULL;
+}
+
+ChunkPipeline *ChunkPipelineCreate(void) {
+    ChunkPipeline *pipeline = (ChunkPipeline *)calloc(1, sizeof(ChunkPipeline));
+    for (int l = 0; l < chunkNumLayers; l++)
+        for (int s = 0; s < chunkPipelineDepth; s++)
+            pipeline->slots[l][s].chunkId = -1;
+    pthread_mutex_init(&pipeline->mutex, NULL);
+    pthread_cond_init(&pipeline->wake, NULL);
+    pthread_cond_init(&pipeline->done, NULL);
+    pthread_create(&pipeline->worker, NULL, ChunkPipelineWorker, pipeline);
+    return pipeline;
+}
+
+void ChunkPipelineDestroy(ChunkPipeline *pipeline) {
+    if (pipeline == NULL) return;
+    pthread_mutex_lock(&pipeline->mutex);
+    pipeline->quit = true;
+    pthread_cond_signal(&pipeline->wake);
+    pthread_mutex_unlock(&pipeline->mutex);
+    pthread_join(pipeline->worker, NULL);
+
+    for (int l = 0; l < chunkNumLayers; l++)
+        for (int s = 0; s < chunkPipelineDepth; s++)
+            if (pipeline->slots[l][s].isPainted) ReleaseRenderTexture(pipeline->slots[l][s].canvas);
+    pthread_mutex_destroy(&pipeline->mutex);
+    pthread_cond_destroy(&pipeline->wake);
+    pthread_cond_destroy(&pipeline->done);
+    free(pipeline);
+}
+
+//------------------------------------------------------------------------------------
+// Thread principal
+//------------------------------------------------------------------------------------
+// Pede os chunks firstChunkId .. firstChunkId + chunkPipelineDepth - 1 da camada
+void ChunkPipelineRequest(ChunkPipeline *pipeline, int layer, int firstChunkId) {
+    bool requested = false;
+    pthread_mutex_lock(&pipeline->mutex);
+    for (int id = firstChunkId; id < firstChunkId + chunkPipelineDepth; id++) {
+        ChunkSlot *slot = &pipeline->slots[layer][id%chunkPipelineDepth];
+        if (slot->chunkId == id || slot->state == CHUNK_SLOT_WORKING) continue; // Já pedido, ou ocupado com um antigo
+        if (slot->isPainted) ReleaseRenderTexture(slot->canvas);
+        slot->isPainted = false;
+        slot->chunkId = id;
+        slot->state = CHUNK_SLOT_QUEUED;
+        requested = true;
+    }
+    if (requested) pthread_cond_signal(&pipeline->wake);
+    pthread_mutex_unlock(&pipeline->mutex);
+}
+
+// Slot com o plano pronto do chunk, ou NULL se ainda não terminou
+ChunkSlot *ChunkPipelinePeek(ChunkPipeline *pipeline, int layer, int chunkId) {
+    ChunkSlot *slot = &pipeline->slots[layer][chunkId%chunkPipelineDepth];
+    pthread_mutex_lock(&pipeline->mutex);
+    bool ready = (slot->chunkId == chunkId && slot->state == CHUNK_SLOT_READY);
+    pthread_mutex_unlock(&pipeline->mutex);
+    return ready ? slot : NULL;
+}
+
+// Slot com o plano do chunk, planejando na hora se a thread de trabalho ainda não fez.
+// Devolver com ChunkPipelineRelease depois de usar
+ChunkSlot *ChunkPipelineTake(ChunkPipeline *pipeline, int layer, int chunkId) {
+    ChunkSlot *slot = &pipeline->slots[layer][chunkId%chunkPipelineDepth];
+    pthread_mutex_lock(&pipeline->mutex);
+    while (slot->state == CHUNK_SLOT_WORKING) // Terminar o que a thread de trabalho está fazendo
+        pthread_cond_wait(&pipeline->done, &pipeline->mutex);
+
+    if (slot->chunkId != chunkId || slot->state != CHUNK_SLOT_READY) {
+        if (slot->isPainted) ReleaseRenderTexture(slot->canvas);
+        slot->isPainted = false;
+        slot->chunkId = chunkId;
+        slot->state = CHUNK_SLOT_WORKING;
+        pipeline->numPlannedOnMainThread++;
+        pthread_mutex_unlock(&pipeline->mutex);
+
+        ProfileBegin(PROF_PLAN_CHUNK);
+        PlanChunk(&slot->plan, layer, chunkId);
+        ProfileEnd(PROF_PLAN_CHUNK);
+
+        pthread_mutex_lock(&pipeline->mutex);
+        slot->state = CHUNK_SLOT_READY;
+    }
+    pthread_mutex_unlock(&pipeline->mutex);
+    return slot;
+}
+
+// O canvas pintado (se houver) passa a ser de quem pegou o slot
+void ChunkPipelineRelease(ChunkPipeline *pipeline, ChunkSlot *slot) {
+    pthread_mutex_lock(&pipeline->mutex);
+    slot->state = CHUNK_SLOT_EMPTY;
+    slot->chunkId = -1;
+    slot->isPainted = false;
+    pthread_mutex_unlock(&pipeline->mutex);
+}
@@ -0,0 +1,186 @@
+#include <stdatomic.h>
+
+// Comandos adiados da simulação
+// O código que roda dentro de um job (update dos inimigos) não pode mexer nas pools e no player, que são
+// compartilhados. Enquanto deferredCommands aponta para um buffer, CreateBullet, CreateParticle, CreateMSG,
+// PlayFx e HurtEntity só anotam o pedido. Cada pedaço do laço paralelo tem o seu buffer e, depois do
+// JobParallelFor, RunDeferredCommands executa os buffers na ordem dos pedaços: o efeito é o mesmo do laço
+// serial, em qualquer número de threads.
+// Um buffer cheio continua num bloco extra ligado a ele, então a ordem de execução continua a dos pedaços.
+// Só sem blocos extras o comando é perdido (contado em numCommandsDropped).
+#define simCommandCapacity 128 // Por buffer. Um inimigo gera no máximo uns 6 comandos por passo
+#define maxCommandBuffers 16   // Pedaços por laço paralelo que gera comandos
+#define maxCommandOverflow 16  // Blocos extras por laço, divididos entre os pedaços que encherem
+
+enum SIM_COMMAND_TYPE {CMD_SOUND, CMD_PARTICLE, CMD_BULLET, CMD_MSG, CMD_HURT};
+
+typedef struct simCommand {
+    enum SIM_COMMAND_TYPE type;
+    union {
+        struct { Sound *soundPool; enum SOUNDS fx; } sound;
+        struct {
+            ParticleSystem *pool;
+            Vector2 position, velocity;
+            enum PARTICLE_TYPES type;
+            float animTime, angularVelocity;
+            Vector2 scaleRange;
+            bool isLoopable;
+            int facingRight;
+        } particle;
+        struct { // Só os campos da Entity que o CreateBullet lê, copiados no momento do tiro
+            Bullet *pool;
+            Vector2 position;
+            int width;
+            float eyesOffsetY;
+            int facingRight;
+            bool upPressed, downPressed;
+            enum BULLET_TYPE type;
+            enum ENTITY_TYPES srcEntity;
+        } bullet;
+        struct { MSGSystem *pool; Vector2 position; int value; } msg;
+        struct { Entity *target; int damage; } hurt;
+    };
+} SimCommand;
+
+typedef struct commandBuffer {
+    SimCommand commands[simCommandCapacity];
+    int count;
+    struct commandBuffer *next; // Bloco extra com a continuação (NULL se este não encheu)
+} CommandBuffer;
+
+static CommandBuffer commandBuffers[maxCommandBuffers];
+static CommandBuffer commandOverflow[maxCommandOverflow];
+static atomic_int numOverflowUsed; // Blocos extras já entregues neste laço
+static long numCommandsOverflow; // Desde o início do programa: comandos que foram para um bloco extra
+static atomic_long numCommandsDropped; // Desde o início do programa: comandos perdidos (sem bloco extra livre)
+static _Thread_local CommandBuffer *deferredCommands = NULL; // Último bloco do pedaço atual. NULL: executa na hora
+
+void BeginDeferredCommands(int chunk) {
+    deferredCommands = &commandBuffers[chunk];
+}
+
+void EndDeferredCommands(void) {
+    deferredCommands = NULL;
+}
+
+// Retorna false fora de um job (quem chamou executa o comando)
+bool DeferCommand(SimCommand command) {
+    if (deferredCommands == NULL) return false;
+    if (deferredCommands->count == simCommandCapacity) {
+        int block = atomic_fetch_add(&numOverflowUsed, 1);
+        if (block >= maxCommandOverflow) { // Executar na hora dentro do job não é seguro
+            atomic_fetch_add(&numCommandsDropped, 1);
+            return true;
+        }
+        deferredCommands->next = &commandOverflow[block];
+        deferredCommands = deferredCommands->next;
+    }
+    deferredCommands->commands[deferredCommands->count++] = command;
+    return true;
+}
+
+bool DeferParticle(Vector2 srcPosition, Vector2 velocity, ParticleSystem *particlePool, enum PARTICLE_TYPES type, float animTime, float angularVelocity, Vector2 scaleRange, bool isLoopable, int facingRight) {
+    if (deferredCommands == NULL) return false;
+    SimCommand command = {CMD_PARTICLE};
+    command.particle.pool = particlePool;
+    command.particle.position = srcPosition;
+    command.particle.velocity = velocity;
+    command.particle.type = type;
+    command.particle.animTime = animTime;
+    command.particle.angularVelocity = angularVelocity;
+    command.particle.scaleRange = scaleRange;
+    command.particle.isLoopable = isLoopable;
+    command.particle.facingRight = facingRight;
+    return DeferCommand(command);
+}
+
+bool DeferBullet(Entity *entity, Bullet *bulletsPool, enum BULLET_TYPE bulletType, enum ENTITY_TYPES srcEntity) {
+    if (deferredCommands == NULL) return false;
+    SimCommand command = {CMD_BULLET};
+    command.bullet.pool = bulletsPool;
+    command.bullet.position = entity->position;
+    command.bullet.width = entity->width;
+    command.bullet.eyesOffsetY = entity->eyesOffset.y;
+    command.bullet.facingRight = entity->lowerAnimation.isFacingRight;
+    command.bullet.upPressed = entity->upPressed;
+    command.bullet.downPressed = entity->downPressed;
+    command.bullet.type = bulletType;
+    command.bullet.srcEntity = srcEntity;
+    return DeferCommand(command);
+}
+
+bool DeferMSG(Vector2 srcPosition, MSGSystem *msgPool, int value) {
+    if (deferredCommands == NULL) return false;
+    SimCommand command = {CMD_MSG};
+    command.msg.pool = msgPool;
+    command.msg.position = srcPosition;
+    command.msg.value = value;
+    return DeferCommand(command);
+}
+
+bool DeferHurt(Entity *entity, int damage) {
+    if (deferredCommands == NULL) return false;
+    SimCommand command = {CMD_HURT};
+    command.hurt.target = entity;
+    command.hurt.damage = damage;
+    return DeferCommand(command);
+}
+
+// Som de efeito da simulação: adiado dentro de um job, na fila de eventos durante o passo, ou tocado na hora
+void PlayFx(Sound *soundPool, enum SOUNDS fx) {
+    SimCommand command = {CMD_SOUND};
+    command.sound.soundPool = soundPool;
+    command.sound.fx = fx;
+    if (DeferCommand(command)) return;
+    if (!QueueFx(soundPool, fx)) PlaySoundMulti(soundPool[fx]);
+}
+
+// Executa os comandos de um bloco, na ordem em que foram anotados
+void RunCommandBlock(CommandBuffer *buffer) {
+    for (int c = 0; c < buffer->count; c++) {
+        SimCommand *command = &buffer->commands[c];
+        switch (command->type) {
+        case CMD_SOUND:
+            PlayFx(command->sound.soundPool, command->sound.fx);
+            break;
+        case CMD_PARTICLE:
+            CreateParticle(command->particle.position, command->particle.velocity, command->particle.pool, command->particle.type, command->particle.animTime,
+                           command->particle.angularVelocity, command->particle.scaleRange, command->particle.isLoopable, command->particle.facingRight);
+            break;
+        case CMD_BULLET: {
+            Entity shooter = { 0 };
+            shooter.position = command->bullet.position;
+            shooter.width = command->bullet.width;
+            shooter.eyesOffset.y = command->bullet.eyesOffsetY;
+            shooter.lowerAnimation.isFacingRight = command->bullet.facingRight;
+            shooter.upPressed = command->bullet.upPressed;
+            shooter.downPressed = command->bullet.downPressed;
+            CreateBullet(&shooter, command->bullet.pool, command->bullet.type, command->bullet.srcEntity);
+            break;
+        }
+        case CMD_MSG:
+            CreateMSG(command->msg.position, command->msg.pool, command->msg.value);
+            break;
+        case CMD_HURT:
+            HurtEntity(command->hurt.target, NULL, command->hurt.damage);
+            break;
+        }
+    }
+}
+
+// Executa e esvazia os buffers 0..numBuffers-1, nessa ordem, cada um seguido dos seus blocos extras
+// (na thread principal, depois do laço paralelo)
+void RunDeferredCommands(int numBuffers) {
+    for (int b = 0; b < numBuffers; b++) {
+        CommandBuffer *buffer = &commandBuffers[b];
+        while (buffer != NULL) {
+            CommandBuffer *next = buffer->next;
+            if (buffer != &commandBuffers[b]) numCommandsOverflow += buffer->count;
+            RunCommandBlock(buffer);
+            buffer->count = 0;
+            buffer->next = NULL;
+            buffer = next;
+        }
+    }
+    atomic_store(&numOverflowUsed, 0);
+}
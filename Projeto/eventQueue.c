@@ -0,0 +1,236 @@
+// Fila de eventos do passo
+// Dano, mortes, explosões, drops e tiros hitscan não são aplicados no meio dos updates: quem detecta o evento só o coloca
+// na fila, e DispatchEvents resolve tudo de uma vez no fim do passo (antes de partículas e mensagens).
+// Assim a cadeia bala -> barril -> explosão -> barril vira uma fila percorrida em ordem, em vez de recursão
+// (as explosões passam pelo explosionResolver, com limite por passo), e nenhuma pool é modificada enquanto outro sistema ainda está iterando sobre ela.
+// Enquanto a fila está aberta, sons, partículas e mensagens de pontos também são guardados (num array à parte, para
+// que efeitos não tomem o lugar de eventos de jogo) e executados em lote, por tipo, depois dos eventos de jogo.
+// Eventos repetidos no mesmo passo são juntados: cada som toca uma vez por passo, o dano no mesmo alvo é somado e
+// cada inimigo morre uma vez só. Nada é perdido com a fila cheia: um evento de jogo é resolvido na hora (como antes
+// da fila) e um efeito é executado por quem chamou.
+#define eventQueueCapacity 1024  // Eventos de jogo por passo (com as pools atuais ficam bem abaixo disso)
+#define effectQueueCapacity 1024 // Sons, partículas e mensagens por passo
+
+enum GAME_EVENT_TYPE {EVENT_HURT, EVENT_KILL, EVENT_EXPLODE, EVENT_SPAWN_PARTICLE, EVENT_PLAY_SOUND, EVENT_SCORE_MSG, EVENT_DROP_LOOT, EVENT_HITSCAN, NUM_GAME_EVENTS};
+
+typedef struct gameEvent {
+    enum GAME_EVENT_TYPE type;
+    union {
+        struct { Entity *target; int damage; } hurt;
+        struct { Enemy *enemy; } kill;
+        struct { Vector2 center; int radius; float energy; enum ENTITY_TYPES srcEntity; } explode;
+        struct {
+            ParticleSystem *pool;
+            Vector2 position, velocity;
+            enum PARTICLE_TYPES type;
+            float animTime, angularVelocity;
+            Vector2 scaleRange;
+            bool isLoopable;
+            int facingRight;
+        } particle;
+        struct { Sound *soundPool; enum SOUNDS fx; } sound;
+        struct { MSGSystem *pool; Vector2 position; int value; } msg;
+        struct { Vector2 position; } loot;
+        HitscanShot hitscan;
+    };
+} GameEvent;
+
+typedef struct eventQueue {
+    GameEvent events[eventQueueCapacity]; // Eventos de jogo
+    int count;
+    int next; // Próximo evento de jogo a resolver (os anteriores já foram aplicados)
+    GameEvent effects[effectQueueCapacity]; // Sons, partículas e mensagens
+    int numEffects;
+    bool isOpen; // Eventos e efeitos entram na fila (do BeginEvents até o lote do DispatchEvents)
+    World *world; // Do passo atual, para resolver na hora um evento que não coube
+    unsigned int soundsQueued; // Bits (1 << SOUNDS) já tocados ou na fila neste passo
+    // Contadores desde o início do programa
+    long numCoalesced; // Eventos juntados a outro
+    long numEventsOverflow; // Eventos de jogo resolvidos na hora com a fila cheia
+    long numEffectsOverflow; // Efeitos executados na hora com a fila cheia
+} EventQueue;
+
+static EventQueue eventQueue;
+
+void ResolveGameEvent(World *world, GameEvent event);
+
+// Início do passo: esvazia a fila e passa a enfileirar eventos e efeitos
+void BeginEvents(World *world) {
+    eventQueue.count = 0;
+    eventQueue.next = 0;
+    eventQueue.numEffects = 0;
+    eventQueue.isOpen = true;
+    eventQueue.world = world;
+    eventQueue.soundsQueued = 0;
+    BeginExplosions();
+}
+
+// Evento de jogo: na fila durante o passo. Com a fila fechada ou cheia é resolvido na hora, nunca perdido
+void QueueEvent(GameEvent event) {
+    if (eventQueue.isOpen && eventQueue.count < eventQueueCapacity) {
+        eventQueue.events[eventQueue.count++] = event;
+        return;
+    }
+    if (eventQueue.isOpen) eventQueue.numEventsOverflow++;
+    if (eventQueue.world != NULL) ResolveGameEvent(eventQueue.world, event);
+}
+
+// Efeito: retorna false com a fila fechada ou cheia (quem chamou executa na hora)
+bool QueueEffect(GameEvent event) {
+    if (!eventQueue.isOpen) return false;
+    if (eventQueue.numEffects == effectQueueCapacity) {
+        eventQueue.numEffectsOverflow++;
+        return false;
+    }
+    eventQueue.effects[eventQueue.numEffects++] = event;
+    return true;
+}
+
+// Dano em player ou inimigo. Soma com um dano ainda não aplicado no mesmo alvo
+void QueueHurt(Entity *target, int damage) {
+    for (int e = eventQueue.next; e < eventQueue.count; e++) {
+        GameEvent *event = &eventQueue.events[e];
+        if (event->type == EVENT_HURT && event->hurt.target == target) {
+            event->hurt.damage += damage;
+            eventQueue.numCoalesced++;
+            return;
+        }
+    }
+    GameEvent event = {EVENT_HURT};
+    event.hurt.target = target;
+    event.hurt.damage = damage;
+    QueueEvent(event);
+}
+
+// Mata o inimigo e dá os pontos dele ao player, uma vez por passo
+void QueueKill(Enemy *enemy) {
+    for (int e = 0; e < eventQueue.count; e++) {
+        if (eventQueue.events[e].type == EVENT_KILL && eventQueue.events[e].kill.enemy == enemy) {
+            eventQueue.numCoalesced++;
+            return;
+        }
+    }
+    GameEvent event = {EVENT_KILL};
+    event.kill.enemy = enemy;
+    QueueEvent(event);
+}
+
+void QueueExplosion(Vector2 center, int radius, float energy, enum ENTITY_TYPES srcEntity) {
+    GameEvent event = {EVENT_EXPLODE};
+    event.explode.center = center;
+    event.explode.radius = radius;
+    event.explode.energy = energy;
+    event.explode.srcEntity = srcEntity;
+    QueueEvent(event);
+}
+
+// Chance de deixar uma caixa de munição ou vida onde um prop foi destruído
+void QueueDropLoot(Vector2 position) {
+    GameEvent event = {EVENT_DROP_LOOT};
+    event.loot.position = position;
+    QueueEvent(event);
+}
+
+// Tiro de SNIPER ou LASER. Retorna false antes do primeiro passo (quem chamou cria um projétil)
+bool QueueHitscan(Entity *shooter, enum BULLET_TYPE bulletType, enum ENTITY_TYPES srcEntity) {
+    if (eventQueue.world == NULL) return false;
+    GameEvent event = {EVENT_HITSCAN};
+    event.hitscan = HitscanFromEntity(shooter, bulletType, srcEntity);
+    QueueEvent(event);
+    return true;
+}
+
+// Retornam false com a fila fechada ou cheia (quem chamou executa na hora)
+bool QueueParticle(Vector2 srcPosition, Vector2 velocity, ParticleSystem *particlePool, enum PARTICLE_TYPES type, float animTime, float angularVelocity, Vector2 scaleRange, bool isLoopable, int facingRight) {
+    if (!eventQueue.isOpen) return false;
+    GameEvent event = {EVENT_SPAWN_PARTICLE};
+    event.particle.pool = particlePool;
+    event.particle.position = srcPosition;
+    event.particle.velocity = velocity;
+    event.particle.type = type;
+    event.particle.animTime = animTime;
+    event.particle.angularVelocity = angularVelocity;
+    event.particle.scaleRange = scaleRange;
+    event.particle.isLoopable = isLoopable;
+    event.particle.facingRight = facingRight;
+    return QueueEffect(event);
+}
+
+bool QueueFx(Sound *soundPool, enum SOUNDS fx) {
+    if (!eventQueue.isOpen) return false;
+    if (eventQueue.soundsQueued & (1u << fx)) {
+        eventQueue.numCoalesced++;
+        return true;
+    }
+    GameEvent event = {EVENT_PLAY_SOUND};
+    event.sound.soundPool = soundPool;
+    event.sound.fx = fx;
+    if (!QueueEffect(event)) return false;
+    eventQueue.soundsQueued |= 1u << fx;
+    return true;
+}
+
+bool QueueMSG(Vector2 srcPosition, MSGSystem *msgPool, int value) {
+    if (!eventQueue.isOpen) return false;
+    GameEvent event = {EVENT_SCORE_MSG};
+    event.msg.pool = msgPool;
+    event.msg.position = srcPosition;
+    event.msg.value = value;
+    return QueueEffect(event);
+}
+
+// Aplica um evento de jogo (os efeitos ficam para o lote do DispatchEvents)
+void ResolveGameEvent(World *world, GameEvent event) {
+    switch (event.type) {
+    case EVENT_HURT: {
+        Entity *target = event.hurt.target;
+        bool wasAlive = target->currentHP > 0;
+        PlayFx(world->fxSoundPool, FX_HURT);
+        target->currentHP -= event.hurt.damage;
+        if (target->type == ENEMY && wasAlive && target->currentHP <= 0)
+            QueueKill((Enemy *)target); // A Entity é o primeiro campo do Enemy
+        break;
+    }
+    case EVENT_KILL:
+        KillEnemy(&world->player, event.kill.enemy, world->msgPool);
+        break;
+    case EVENT_EXPLODE:
+        PushExplosion((Explosion) {event.explode.center, event.explode.radius, event.explode.energy, event.explode.srcEntity});
+        break;
+    case EVENT_DROP_LOOT:
+        if (RngValue(RNG_EFFECTS, 1,100) <= fmin(world->difficulty*0.25f, 4))  // 2% de chance de dropar ammo ou hp
+            CreateEnvProp(world->envPropsPool, world->groundPool, (RngValue(RNG_EFFECTS, 1,2) == 1 ? AMMO_CRATE : HP_CRATE), event.loot.position, 130, 130);
+        break;
+    case EVENT_HITSCAN:
+        FireHitscan(world, event.hitscan);
+        break;
+    default:
+        break;
+    }
+}
+
+// Resolve os eventos de jogo na ordem em que entraram (os gerados aqui entram no fim e são resolvidos
+// na mesma chamada), uma explosão pendente por vez até acabar o orçamento do passo, e depois executa
+// sons, partículas e mensagens em lote, um tipo por vez
+void DispatchEvents(World *world) {
+    do {
+        for (; eventQueue.next < eventQueue.count; eventQueue.next++)
+            ResolveGameEvent(world, eventQueue.events[eventQueue.next]);
+    } while (ResolveNextExplosion(world)); // Mortes e barris atingidos entram na fila antes da próxima explosão
+
+    eventQueue.isOpen = false;
+    for (int e = 0; e < eventQueue.numEffects; e++) {
+        GameEvent *event = &eventQueue.effects[e];
+        if (event->type == EVENT_PLAY_SOUND) PlaySoundMulti(event->sound.soundPool[event->sound.fx]);
+    }
+    for (int e = 0; e < eventQueue.numEffects; e++) {
+        GameEvent *event = &eventQueue.effects[e];
+        if (event->type == EVENT_SPAWN_PARTICLE)
+            CreateParticle(event->particle.position, event->particle.velocity, event->particle.pool, event->particle.type, event->particle.animTime,
+                           event->particle.angularVelocity, event->particle.scaleRange, event->particle.isLoopable, event->particle.facingRight);
+    }
+    for (int e = 0; e < eventQueue.numEffects; e++) {
+        GameEvent *event = &eventQueue.effects[e];
+        if (event->type == EVENT_SCORE_MSG) CreateMSG(event->msg.position, event->msg.pool, event->msg.value);
+    }
+}
@@ -0,0 +1,77 @@
+// Resolução das explosões em cadeia
+// Cada explosão entra numa fila circular e é resolvida pelo DispatchEvents em ordem de chegada: os barris
+// atingidos por uma explosão entram no fim da fila, então a cadeia é percorrida em largura, sem recursão.
+// Explosões repetidas (mesmo centro e raio, ex: granada encostando em dois inimigos no mesmo passo) são
+// descartadas. No máximo maxExplosionsPerStep são resolvidas por passo; o resto fica na fila para os
+// próximos passos, então uma pilha grande de barris explode em onda, com custo por passo limitado.
+#define explosionQueueCapacity 128
+#define maxExplosionsPerStep 8
+
+typedef struct explosion {
+    Vector2 center;
+    int radius;
+    float energy;
+    enum ENTITY_TYPES srcEntity;
+} Explosion;
+
+typedef struct explosionResolver {
+    Explosion pending[explosionQueueCapacity]; // Fila circular
+    int first, count;
+    Explosion resolved[maxExplosionsPerStep]; // Já resolvidas neste passo (para descartar repetidas)
+    int numResolved;
+    long numMerged; // Repetidas descartadas (acumulado, aparece no F3)
+    long numDropped; // Fila cheia, a explosão é perdida (acumulado, aparece no F3)
+} ExplosionResolver;
+
+static ExplosionResolver explosionResolver;
+
+// Nova partida: descarta as explosões que ficaram na fila
+void ResetExplosions(void) {
+    explosionResolver.first = 0;
+    explosionResolver.count = 0;
+    explosionResolver.numResolved = 0;
+}
+
+// Início do passo: renova o orçamento
+void BeginExplosions(void) {
+    explosionResolver.numResolved = 0;
+}
+
+bool SameExplosion(Explosion *a, Explosion *b) {
+    return a->radius == b->radius && fabsf(a->center.x - b->center.x) < 1 && fabsf(a->center.y - b->center.y) < 1;
+}
+
+void PushExplosion(Explosion explosion) {
+    ExplosionResolver *resolver = &explosionResolver;
+    for (int n = 0; n < resolver->numResolved; n++) {
+        if (SameExplosion(&resolver->resolved[n], &explosion)) {
+            resolver->numMerged++;
+            return;
+        }
+    }
+    for (int n = 0; n < resolver->count; n++) {
+        if (SameExplosion(&resolver->pending[(resolver->first + n) % explosionQueueCapacity], &explosion)) {
+            resolver->numMerged++;
+            return;
+        }
+    }
+    if (resolver->count == explosionQueueCapacity) {
+        resolver->numDropped++;
+        return;
+    }
+    resolver->pending[(resolver->first + resolver->count) % explosionQueueCapacity] = explosion;
+    resolver->count++;
+}
+
+// Resolve a próxima explosão da fila. Retorna false com a fila vazia ou o orçamento do passo esgotado
+bool ResolveNextExplosion(World *world) {
+    ExplosionResolver *resolver = &explosionResolver;
+    if (resolver->count == 0 || resolver->numResolved == maxExplosionsPerStep) return false;
+    Explosion explosion = resolver->pending[resolver->first];
+    resolver->first = (resolver->first + 1) % explosionQueueCapacity;
+    resolver->count--;
+    resolver->resolved[resolver->numResolved++] = explosion;
+    ExplosionAOE(&world->player, world->msgPool, world->envPropsPool, world->enemyPool, world->groundPool, world->particlePool, world->fxSoundPool,
+                 explosion.radius, explosion.energy, explosion.center, explosion.srcEntity, world->difficulty);
+    return true;
+}
@@ -1,71 +1,67 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Player frames ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-int static PLAYER_GRID[2] = {122, 122};
-// LEGS são as animações exclusivas a parte inferior do player
-int static PLAYER_LEGS_IDLE_ROW = 0;
-int static PLAYER_LEGS_IDLE_NUM_FRAMES = 6;
-int static PLAYER_LEGS_JUMPING_ROW = 1;
-int static PLAYER_LEGS_JUMPING_NUM_FRAMES = 5; // Não conta com o frame de "falling"
-int static PLAYER_LEGS_WALKING_ROW = 2;
-int static PLAYER_LEGS_WALKING_NUM_FRAMES = 8;
-// UPPER são as animações exclusivas a parte superior do player
-int static PLAYER_UPPER_IDLE_ROW = 3;
-int static PLAYER_UPPER_IDLE_NUM_FRAMES = 6;
-int static PLAYER_UPPER_JUMPING_ROW = 4;
-int static PLAYER_UPPER_JUMPING_NUM_FRAMES = 5; // Não conta com o frame de "falling"
-int static PLAYER_UPPER_ATTACKING_45U_ROW = 5;
-int static PLAYER_UPPER_ATTACKING_45U_NUM_FRAMES = 4;
-int static PLAYER_UPPER_ATTACKING_45D_ROW = 6;
-int static PLAYER_UPPER_ATTACKING_45D_NUM_FRAMES = 4;
-int static PLAYER_UPPER_ATTACKING_ROW = 7;
-int static PLAYER_UPPER_ATTACKING_NUM_FRAMES = 4;
-int static PLAYER_UPPER_WALKING_ROW = 8;
-int static PLAYER_UPPER_WALKING_NUM_FRAMES = 8;
-int static PLAYER_UPPER_THROWING_ROW = 9;
-int static PLAYER_UPPER_THROWING_NUM_FRAMES = 5;
-// BODY são as animações do player como um todo (controlados por lowerAnimation)
-int static PLAYER_BODY_DYING_ROW = 10;
-int static PLAYER_BODY_DYING_NUM_FRAMES = 7;
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Assassin frames /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-int static ASSASSIN_GRID[2] = {135, 135};
-// LEGS são as animações exclusivas a parte inferior do Assassin
-int static ASSASSIN_LEGS_IDLE_ROW = 0;
-int static ASSASSIN_LEGS_IDLE_NUM_FRAMES = 8;
-int static ASSASSIN_LEGS_WALKING_ROW = 1;
-int static ASSASSIN_LEGS_WALKING_NUM_FRAMES = 8;
-// UPPER são as animações exclusivas a parte superior do Assassin
-int static ASSASSIN_UPPER_IDLE_ROW = 2;
-int static ASSASSIN_UPPER_IDLE_NUM_FRAMES = 8;
-int static ASSASSIN_UPPER_WALKING_ROW = 3;
-int static ASSASSIN_UPPER_WALKING_NUM_FRAMES = 8;
-int static ASSASSIN_UPPER_ATTACKING_ROW = 4;
-int static ASSASSIN_UPPER_ATTACKING_NUM_FRAMES = 6;
-// BODY são as animações do Assassin como um todo (controlados por lowerAnimation)
-int static ASSASSIN_BODY_DYING_ROW = 5;
-int static ASSASSIN_BODY_DYING_NUM_FRAMES = 8;
-
-// GUNNER frames /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-int static GUNNER_GRID[2] = {135, 135};
-// LEGS são as animações exclusivas a parte inferior do GUNNER
-int static GUNNER_LEGS_IDLE_ROW = 0;
-int static GUNNER_LEGS_IDLE_NUM_FRAMES = 7;
-int static GUNNER_LEGS_WALKING_ROW = 1;
-int static GUNNER_LEGS_WALKING_NUM_FRAMES = 8;
-// UPPER são as animações exclusivas a parte superior do GUNNER
-int static GUNNER_UPPER_IDLE_ROW = 2;
-int static GUNNER_UPPER_IDLE_NUM_FRAMES = 7;
-int static GUNNER_UPPER_WALKING_ROW = 3;
-int static GUNNER_UPPER_WALKING_NUM_FRAMES = 8;
-int static GUNNER_UPPER_ATTACKING_ROW = 4;
-int static GUNNER_UPPER_ATTACKING_NUM_FRAMES = 4;
-// BODY são as animações do GUNNER como um todo (controlados por lowerAnimation)
-int static GUNNER_BODY_DYING_ROW = 5;
-int static GUNNER_BODY_DYING_NUM_FRAMES = 6;
+// Clips de animação dos personagens ///////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Cada classe de personagem tem uma tabela fixa, indexada pelo CHARACTER_STATE de cada metade do corpo.
+// A Entity só guarda o ponteiro para a tabela da sua classe.
+typedef struct animationClip {
+    int row; // Linha no atlas (-1: sem quadro próprio, a outra metade desenha o corpo todo)
+    int numFrames; // 0: estado sem animação
+    bool isLoopable;
+    bool isFixed; // No fim fica parado em fixedFrame
+    int fixedFrame;
+    bool transitToAnotherState; // No fim passa para nextState
+    enum CHARACTER_STATE nextState;
+} AnimationClip;
+
+typedef struct characterClips {
+    int grid[2];
+    AnimationClip lower[DEAD + 1]; // LEGS e BODY
+    AnimationClip upper[DEAD + 1]; // UPPER (ATTACKING usa upperAttacking)
+    AnimationClip upperAttacking[DOWN45 + 1]; // Por CHARACTER_AIMING
+} CharacterClips;
+
+#define CLIP_LOOP(row, numFrames) {row, numFrames, true, false, -1, false, IDLE}
+#define CLIP_ONCE(row, numFrames) {row, numFrames, false, false, -1, false, IDLE} // Para no último quadro
+#define CLIP_HOLD(row, numFrames, fixedFrame) {row, numFrames, false, true, fixedFrame, false, IDLE}
+#define CLIP_THEN(row, numFrames, nextState) {row, numFrames, false, false, -1, true, nextState}
+#define CLIP_NONE(row) {row, 0, false, false, -1, false, IDLE}
+
+// Player ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// JUMPING tem 5 quadros mais o de "falling", usado parado no FALLING
+static const CharacterClips playerClips = {
+    {122, 122},
+    {[IDLE] = CLIP_LOOP(0, 6), [WALKING] = CLIP_LOOP(2, 8), [JUMPING] = CLIP_ONCE(1, 5), [FALLING] = CLIP_HOLD(1, 5, 5),
+     [ATTACKING] = CLIP_NONE(0), [THROWING] = CLIP_NONE(0), [DYING] = CLIP_ONCE(10, 7), [DEAD] = CLIP_NONE(0)},
+    {[IDLE] = CLIP_LOOP(3, 6), [WALKING] = CLIP_LOOP(8, 8), [JUMPING] = CLIP_ONCE(4, 5), [FALLING] = CLIP_HOLD(4, 5, 5),
+     [ATTACKING] = CLIP_NONE(0), [THROWING] = CLIP_THEN(9, 5, IDLE), [DYING] = CLIP_NONE(-1), [DEAD] = CLIP_NONE(0)},
+    {[FORWARD] = CLIP_THEN(7, 4, IDLE), [UP45] = CLIP_THEN(5, 4, IDLE), [DOWN45] = CLIP_THEN(6, 4, IDLE)}
+};
+
+// Inimigos /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Sem animação de pulo/queda (usam idle) e sem arremesso
+#define ENEMY_CLIPS(grid0, grid1, legsIdle, legsWalking, upperIdle, upperWalking, upperAttacking, bodyDying) { \
+    {grid0, grid1}, \
+    {[IDLE] = legsIdle, [WALKING] = legsWalking, [JUMPING] = legsIdle, [FALLING] = legsIdle, \
+     [ATTACKING] = CLIP_NONE(0), [THROWING] = CLIP_NONE(0), [DYING] = bodyDying, [DEAD] = CLIP_NONE(0)}, \
+    {[IDLE] = upperIdle, [WALKING] = upperWalking, [JUMPING] = upperIdle, [FALLING] = upperIdle, \
+     [ATTACKING] = CLIP_NONE(0), [THROWING] = CLIP_NONE(0), [DYING] = CLIP_NONE(-1), [DEAD] = CLIP_NONE(0)}, \
+    {[FORWARD] = upperAttacking, [UP45] = upperAttacking, [DOWN45] = upperAttacking} \
+}
+
+static const CharacterClips assassinClips = ENEMY_CLIPS(135, 135,
+    CLIP_LOOP(0, 8), CLIP_LOOP(1, 8), CLIP_LOOP(2, 8), CLIP_LOOP(3, 8), CLIP_THEN(4, 6, IDLE), CLIP_ONCE(5, 8));
+
+static const CharacterClips gunnerClips = ENEMY_CLIPS(135, 135,
+    CLIP_LOOP(0, 7), CLIP_LOOP(1, 8), CLIP_LOOP(2, 7), CLIP_LOOP(3, 8), CLIP_THEN(4, 4, IDLE), CLIP_ONCE(5, 6));
+
+// Classes ainda sem sprite sheet próprio usam o layout do player
+static const CharacterClips playerLayoutEnemyClips = ENEMY_CLIPS(122, 122,
+    CLIP_LOOP(0, 6), CLIP_LOOP(2, 8), CLIP_LOOP(3, 6), CLIP_LOOP(8, 8), CLIP_THEN(7, 4, IDLE), CLIP_ONCE(10, 7));
+
+// Por ENEMY_CLASSES
+static const CharacterClips *const enemyClassClips[BOSS + 1] = {
+    &playerLayoutEnemyClips, &assassinClips, &gunnerClips, &playerLayoutEnemyClips, &playerLayoutEnemyClips, &playerLayoutEnemyClips, &playerLayoutEnemyClips
+};
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Objects frames //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1,7 +1,21 @@
+#include "allocGuard.c" // Primeiro: as macros de -DALLOC_GUARD valem para todo o resto
 #include <time.h>
 #include <math.h>
 #include "raylib.h"
-#include "frameMapping.c"
+#include "rng.c"
+#include "replay.c"
+#include "jobSystem.c"
+#include "profiler.c"
+#include "renderTexturePool.c"
+#include "assetArchive.c"
+#include "assetCache.c"
+#include "chunkPipeline.c"
+#include "arena.c"
+#include "spatialHash.c"
+#include "sweptCollision.c"
+#include "objectPool.c"
+#include "particleSystem.c"
+#include "spriteBatch.c"
 
 
 // Enums
@@ -10,6 +24,7 @@ enum CHARACTER_STATE{IDLE, WALKING, JUMPING, FALLING, ATTACKING, THROWING, DYING
 enum CHARACTER_AIMING{FORWARD, UP45, DOWN45};
 enum ENTITY_TYPES{PLAYER, ENEMY};
 enum ENEMY_BEHAVIOR{NONE, ATTACK, MOVE};
+enum ENEMY_LOD{ENEMY_LOD_FULL, ENEMY_LOD_REDUCED, ENEMY_LOD_ASLEEP, NUM_ENEMY_LOD}; // Nível de detalhe da simulação, pela distância ao player
 enum BACKGROUND_TYPES{BACKGROUND, MIDDLEGROUND, FOREGROUND};
 enum BACKGROUND_STYLE{SKYSCRAPER};
 enum MIDDLEGROUND_STYLE{COMPLEX, RED_BUILDING};
@@ -21,24 +36,40 @@ enum OBJECTS_TYPES {METAL_CRATE, AMMO_CRATE, HP_CRATE, CARD_CRATE1, CARD_CRATE2,
 enum PARTICLE_TYPES {EXPLOSION, SMOKE, BLOOD_SPILL, MAGNUM_SHOOT};
 enum SOUNDS {FX_MAGNUM, FX_SWORD, FX_CHANGE_SELECTION, FX_SELECTED, FX_ENTITY_LANDING, FX_GRENADE_LAUNCH, FX_GRENADE_BOUNCING, FX_GRENADE_EXPLOSION, FX_HURT, FX_DYING};
 
+// Quadros dos atlas (as tabelas de animação são indexadas pelos enums acima)
+#include "frameMapping.c"
+
 // Consts
 const float GRAVITY = 600; // px / f²
 const float bulletLifeTime = 0.65; // s
+const float beamLifeTime = 0.12f; // s, feixe de um tiro hitscan na tela
 const float grenadeExplosionTime = 2.5f; // s
 const float msgTime = 3; // s
 const float corpseTime = 2; // s
+const float fixedTimeStep = 1.0f/60.0f; // s, passo fixo da simulação
+const static int maxStepsPerFrame = 5; // Passos de simulação por frame, no máximo (evita espiral quando o frame demora)
 const static int numBackgroundRendered = 7;
+const static float enemyFullSimDistance = 1920; // px do player até onde o inimigo é simulado a cada passo (1 tela)
+const static float enemyAsleepDistance = 2*1920; // px do player a partir do qual o inimigo fica parado
+const static int enemyReducedTickInterval = 4; // Passos entre updates no nível reduzido
+const static int enemyJobBatchSize = 8; // Inimigos por pedaço no update paralelo (no mínimo)
+const static float cullMargin = 200.0f; // px além da tela em que um objeto ainda é desenhado (sprites girados, origem no centro)
 const static int maxNumBullets = 100;
-const static int maxNumParticles = 500;
+const static int maxNumParticles = 32768;
 const static int maxNumGrenade = 50;
+const static int maxGrenadeSweeps = 3; // Trechos varridos por passo (quiques no mesmo passo)
+const static int maxNumBeams = 32;
 const static int maxNumEnemies = 60;
 const static int maxNumGrounds = 300;
 const static int maxNumEnvProps = 50;
 const static int maxNumMSGs = 50;
-const static int numEnemyClasses = 6;
+const static size_t runArenaCapacity = 4*1024*1024; // Pools, broadphase e backgrounds de uma partida (~2.1 MB usados)
+const static int numEnemyClasses = BOSS + 1;
 const int screenWidth = 1920;
 const int screenHeight = 1080;
 const char gameName[30] = "Project N30-N";
+const char lastRunReplayFile[] = "resources/last_run.rpl"; // Toda partida jogada é gravada aqui
+const char profileTraceFile[] = "profile_trace.json"; // Exportado com F4 quando o profiler está ligado
 bool isFullscreen = true;
 
 // Structs
@@ -67,6 +98,7 @@ typedef struct entity {
     float characterWidthScale;
     float characterHeightScale;
     Rectangle drawableRect;
+    Rectangle prevDrawableRect; // drawableRect do passo anterior, para interpolar no desenho
     Rectangle collisionBox;
     Circle collisionHead;
     Vector2 position;
@@ -88,20 +120,7 @@ typedef struct entity {
     bool upPressed;
     bool downPressed;
 
-    //////
-    int GRID[2];
-    int LEGS_IDLE_ROW;
-    int LEGS_IDLE_NUM_FRAMES;
-    int LEGS_WALKING_ROW;
-    int LEGS_WALKING_NUM_FRAMES;
-    int UPPER_IDLE_ROW;
-    int UPPER_IDLE_NUM_FRAMES;
-    int UPPER_WALKING_ROW;
-    int UPPER_WALKING_NUM_FRAMES;
-    int UPPER_ATTACKING_ROW;
-    int UPPER_ATTACKING_NUM_FRAMES;
-    int BODY_DYING_ROW;
-    int BODY_DYING_NUM_FRAMES;
+    const CharacterClips *clips; // Tabela de animação da classe
 
 } Entity;
 
@@ -109,6 +128,7 @@ typedef struct player
 {
     Entity entity;
     long points;
+    InputFrame input; // Entrada do tick atual (teclado, script ou replay)
 
 }  Player;
 
@@ -128,12 +148,24 @@ typedef struct enemy
     Vector2 spawnLocation;
     float maxDistanceToSpawn;
     bool isAlive;
+    bool isKilled; // Pontos já dados ao player (o corpo continua na pool até o fim da animação)
     float attackSpeed;
     float timeSinceLastAttack;
     int pointsWorth;
+    enum ENEMY_LOD lod;
+    int lodSkippedSteps; // Passos sem update no nível reduzido, simulados de uma vez no próximo
+    Rng aiRng; // Decisões da IA. Um por inimigo, para que o update dos inimigos possa rodar em paralelo
 
 } Enemy;
 
+// Parte do inimigo usada nas colisões de balas, granadas e explosões, num array separado da enemyPool
+// (mesmo índice). Copiada do Enemy uma vez por passo, no UpdateEnemyGrid, junto com a broadphase
+typedef struct enemyCollider {
+    Rectangle collisionBox;
+    Circle collisionHead;
+    bool isHittable; // Vivo, com vida e não morrendo
+} EnemyCollider;
+
 typedef struct ground {
     Rectangle rect;
     bool canBeStepped;
@@ -161,33 +193,6 @@ typedef struct background {
 } Background;
 
 
-typedef struct particle {
-    int id;
-    Vector2 position;
-    Vector2 velocity;
-    Rectangle drawableRect;
-    Rectangle frameRect;
-    int width;
-    int height;
-    enum PARTICLE_TYPES type;
-    float animationFrameSpeed;
-    int numFrames;
-    int frameRow; // Só será usada se for um atlas para as partículas. Em caso de arquivo individual, pode deletar a variável
-    int currentAnimationFrame;
-    float timeSinceLastFrame;
-    float angle;
-    float angularVelocity;
-    Vector2 scaleRange;
-    float scale;
-    bool scaleUp;
-    int loopAllowed;
-    int isFacingRight;
-    float timeToDestroy;
-    float lifeTime;
-    bool isActive;
-
-} Particle;
-
 typedef struct msgsystem {
     int id;
     Vector2 position;
@@ -213,6 +218,7 @@ typedef struct bullet {
     float lifeTime;
     bool isActive;
     Rectangle drawableRect;
+    Rectangle prevDrawableRect;
     Rectangle collisionBox;
 
 } Bullet;
@@ -231,10 +237,22 @@ typedef struct grenade {
     float lifeTime;
     bool isActive;
     Rectangle drawableRect;
+    Rectangle prevDrawableRect;
     Circle collisionCircle;
 
 } Grenade;
 
+// Feixe deixado por um tiro hitscan (SNIPER, LASER). Só desenho: o dano foi aplicado no passo do tiro
+typedef struct beam {
+    Vector2 start;
+    Vector2 end;
+    float angle;
+    enum BULLET_TYPE bulletType;
+    float lifeTime;
+    int currentFrame;
+    bool isActive;
+} Beam;
+
 typedef struct envProps {
     int id;
     int groundID;
@@ -248,45 +266,126 @@ typedef struct envProps {
     int pointsWorth;
 } EnvProps;
 
+// Inimigo a atualizar neste passo, com o tempo decidido pelo nível de detalhe (lista do update paralelo)
+typedef struct enemyStep {
+    int index;
+    float delta;
+} EnemyStep;
+
+typedef struct world {
+    // Controle de fluxo do jogo
+    uint64_t seed; // Seed da partida, origem de todos os streams de RNG
+    float time;
+    int difficulty;
+    Player player;
+    Camera2D camera;
+    Camera2D prevCamera; // Câmera do passo anterior, para interpolar no desenho
+    int numDrawn, numCulled; // Objetos desenhados e descartados pelo culling no último DrawWorld
+    int numEnemiesByLod[NUM_ENEMY_LOD]; // Inimigos em cada nível de detalhe no último passo
+    float accumulator; // Tempo ainda não simulado (< fixedTimeStep)
+    float alpha; // Fração do próximo passo já decorrida, usada na interpolação
+    unsigned char pendingPressed; // Teclas apertadas em frames sem passo, entregues no próximo passo
+    ReplayWriter *recorder; // Grava a entrada de cada passo (NULL se não estiver gravando)
+    ReplayReader *playback; // Entrada vem do replay em vez do teclado (NULL se não estiver reproduzindo)
+    float camMinX; // Usado no avanço da câmera e na limitação de movimentação para trás do player
+    float camMaxX; // Usado no avanço da câmera
+
+    // Pools (todas alocadas na arena da partida)
+    Arena arena;
+    Bullet *bulletsPool;
+    Grenade *grenadesPool;
+    Beam *beamsPool;
+    Ground *groundPool;
+    EnvProps *envPropsPool;
+    Enemy *enemyPool;
+    ParticleSystem *particlePool;
+    MSGSystem *msgPool;
+    Background *nearBackgroundPool;
+    Background *middleBackgroundPool;
+    Background *farBackgroundPool;
+    SpatialHash groundGrid, envPropsGrid, enemyGrid; // Broadphase, reconstruída a cada frame
+    EnemyCollider *enemyColliders; // Hot data da enemyPool
+    EnemyStep *enemySteps; // maxNumEnemies
+    int numNearBackground, numMiddleBackground, numFarBackground; // Usado para posicionamento correto das novas imagens geradas
+    ChunkPipeline *chunkPipeline; // Planeja os próximos chunks em outra thread
+
+    // Assets usados pela simulação (geração de chunks e sons)
+    Texture2D backgroundAtlas;
+    Texture2D midgroundAtlas;
+    Texture2D foregroundAtlas;
+    Sound *fxSoundPool;
+} World;
+
 // Headers
 Texture2D CreateTexture(enum BACKGROUND_TYPES bgLayer, Image srcAtlas);
 void CreateBullet(Entity *entity, Bullet *bulletsPool, enum BULLET_TYPE bulletType, enum ENTITY_TYPES srcEntity);
 int CreateGround(Ground *groundPool, Vector2 position, int width, int height, bool canBeStepped, bool followCamera, bool blockPlayer, bool isInvisible, bool isFromObject, enum OBJECTS_TYPES objType);
 void CreateEnvProp(EnvProps *envPropsPool, Ground *groundPool, enum OBJECTS_TYPES obType, Vector2 position, int width, int height);
-Background CreateBackground(Player *player, Enemy *enemyPool, EnvProps *envPropsPool, Background *backgroundPool, Ground *groundPool, Texture2D srcAtlas, enum BACKGROUND_TYPES bgType, int *numBackground, int id, int difficulty);
+Background CreateBackground(Player *player, Enemy *enemyPool, EnvProps *envPropsPool, Background *backgroundPool, Ground *groundPool, ChunkPipeline *chunkPipeline, Texture2D srcAtlas, enum BACKGROUND_TYPES bgType, int *numBackground, int id, int difficulty);
 Camera2D CreateCamera (Vector2 target, Vector2 offset, float rotation, float zoom);
 Player CreatePlayer(int maxHP, Vector2 position, int width, int height);
 void CreateEnemy(Enemy *enemyPool, enum ENEMY_CLASSES class, Vector2 position, int width, int height);
 void CreateGrenade(Entity *entity, Grenade *grenadePool, enum ENTITY_TYPES srcEntity);
-void CreateParticle(Vector2 srcPosition, Vector2 velocity, Particle *particlePool, enum PARTICLE_TYPES type, float animTime, float angularVelocity, Vector2 scaleRange, bool isLoopable, int facingRight);
+void CreateParticle(Vector2 srcPosition, Vector2 velocity, ParticleSystem *particlePool, enum PARTICLE_TYPES type, float animTime, float angularVelocity, Vector2 scaleRange, bool isLoopable, int facingRight);
 void CreateMSG(Vector2 srcPosition, MSGSystem *msgPool, int value);
 
-void DestroyEnvProp(Player *player, Enemy *enemyPool,EnvProps *envPropsPool, Ground *groundsPool, Particle *particlePool, Sound *soundPool, MSGSystem *msgSystem, int envPropID, int difficulty);
+void PlayFx(Sound *soundPool, enum SOUNDS fx);
+void HurtEntity(Entity *dstEntity, Sound *soundPool, int damage);
+bool SweepRectBody(Rectangle box, Vector2 motion, Rectangle body, Circle head, float *tHit);
+void KillEnemy(Player *player, Enemy *enemy, MSGSystem *msgSystem);
+void ExplosionAOE(Player *player, MSGSystem *msgSystem, EnvProps *envPropPool, Enemy *enemyPool, Ground *groundPool, ParticleSystem *particlePool, Sound *soundPool, int explosionRadius, float energy, Vector2 centerOfExplosion, enum ENTITY_TYPES srcEntity, int difficulty);
+
+void DestroyEnvProp(Player *player, Enemy *enemyPool,EnvProps *envPropsPool, Ground *groundsPool, ParticleSystem *particlePool, Sound *soundPool, MSGSystem *msgSystem, int envPropID, int difficulty);
 
-void UpdateBackground(Player *player, Background *backgroundPool, int i, Texture2D srcAtlas, Enemy *enemyPool, EnvProps *envPropsPool, Ground *groundPool, float delta, int *numBackground, float minX, float *maxX, int difficulty);
+void UpdateBackground(Player *player, Background *backgroundPool, int i, Texture2D srcAtlas, Enemy *enemyPool, EnvProps *envPropsPool, Ground *groundPool, ChunkPipeline *chunkPipeline, float delta, int *numBackground, float minX, float *maxX, int difficulty);
 void UpdateClampedCameraPlayer(Camera2D *camera, Player *player, float delta, int width, int height, float *minX, float *maxX);
-void UpdatePlayer(Player *player, Enemy *enemy, Bullet *bulletPool, Grenade *grenadePool, float delta, Ground *ground, EnvProps *envProps, Particle *particlePool, Sound *soundPool, MSGSystem *msgSystem, float minX, int difficulty);
-void UpdateBullets(Bullet *bullet, Enemy *enemyPool, Player *player, MSGSystem *msgSystem, Ground *groundsPool, EnvProps *envPropsPool, Sound *soundPool, Particle *particlePool, float delta, int maxX, int difficulty);
-void UpdateEnemy(Enemy *enemy, Player *player, Bullet *bulletPool, float delta, Ground *ground, EnvProps *envProps, Sound *soundPool, Particle *particlePool, MSGSystem *msgSystem, int minX, int difficulty);
+void UpdatePlayer(Player *player, Enemy *enemy, Bullet *bulletPool, Grenade *grenadePool, float delta, Ground *ground, EnvProps *envProps, ParticleSystem *particlePool, Sound *soundPool, MSGSystem *msgSystem, float minX, int difficulty);
+void UpdateBullets(Bullet *bullet, Enemy *enemyPool, Player *player, MSGSystem *msgSystem, Ground *groundsPool, EnvProps *envPropsPool, Sound *soundPool, ParticleSystem *particlePool, float delta, int maxX, int difficulty);
+float EnemyLodStep(Enemy *enemy, Player *player, float delta);
+void UpdateEnemy(Enemy *enemy, Player *player, Bullet *bulletPool, float delta, Ground *ground, EnvProps *envProps, Sound *soundPool, ParticleSystem *particlePool, MSGSystem *msgSystem, int minX, int difficulty, bool animate);
 void UpdateGrounds(Player *player, Ground *ground, float delta, float minX);
-void UpdateEnvProps(Player *player, Enemy *enemyPool, EnvProps *envPropsPool, Ground *groundsPool, Particle *particlePool, Sound *soundPool, MSGSystem *msgSystem, float delta, float minX);
-void UpdateGrenades(Grenade *grenade, Enemy *enemy, Player *player, MSGSystem *msgSystem, Ground *ground, EnvProps *envProp, Particle *particlePool, Sound *soundPool, float delta, int difficulty);
-void UpdateParticles(Particle *particlePool, float delta, float minX);
+void UpdateEnvProps(Player *player, Enemy *enemyPool, EnvProps *envPropsPool, Ground *groundsPool, ParticleSystem *particlePool, Sound *soundPool, MSGSystem *msgSystem, float delta, float minX);
+void UpdateBeam(Beam *beam, float delta);
+float SweepGrenade(Grenade *grenade, Enemy *enemy, Ground *ground, Vector2 motion, float *hitT, Vector2 *hitNormal);
+void UpdateGrenades(Grenade *grenade, Enemy *enemy, Player *player, MSGSystem *msgSystem, Ground *ground, EnvProps *envProp, ParticleSystem *particlePool, Sound *soundPool, float delta, int difficulty);
+void UpdateParticles(ParticleSystem *particlePool, float delta, float minX);
 void UpdateMSGs(MSGSystem *curMsg, float delta);
 void UpdateDifficulty(int *difficulty, float minX, float time);
 
-void DrawEnemy(Enemy *enemy, Texture2D *texture, bool drawDetectionCollision, bool drawLife, bool drawCollisionBox);
-void DrawBullet(Bullet *bullet, Texture2D texture, bool drawCollisionBox);
-void DrawPlayer(Player *player, Texture2D texture, bool drawCollisionBox);
-void DrawGrenade(Grenade *grenade, Texture2D texture, bool drawCollisionCircle);
-void DrawParticle(Particle *particle, Texture2D texture);
+void InitWorld(World *world, Texture2D backgroundAtlas, Texture2D midgroundAtlas, Texture2D foregroundAtlas, Sound *fxSoundPool, uint64_t seed);
+void UpdateEnemiesChunk(void *context, int begin, int end, int chunk);
+void UpdateWorld(World *world, float deltaTime);
+int StepWorld(World *world, float frameTime, InputFrame liveInput);
+void UnloadWorld(World *world);
+void UpdateChunkPipeline(World *world);
+void StopReplay(World *world);
+void UpdateGroundGrids(World *world);
+void UpdateEnemyGrid(World *world);
+void DrawLoadingScreen(float progress);
+void DrawWorld(World *world, Texture2D characterTex, Texture2D miscAtlas, Texture2D envPropsAtlas, Texture2D *enemyTex);
+
+Rectangle LerpRect(Rectangle prev, Rectangle cur, float alpha);
+Camera2D LerpCamera(Camera2D prev, Camera2D cur, float alpha);
+Rectangle GetCameraView(Camera2D camera, float margin);
+bool CullRect(World *world, Rectangle view, Rectangle rect);
+void DrawEnemy(Enemy *enemy, Texture2D *texture, bool drawDetectionCollision, bool drawLife, bool drawCollisionBox, float alpha);
+void DrawBullet(Bullet *bullet, Texture2D texture, bool drawCollisionBox, float alpha);
+void DrawBeam(Beam *beam, Texture2D texture);
+void DrawPlayer(Player *player, Texture2D texture, bool drawCollisionBox, float alpha);
+void DrawGrenade(Grenade *grenade, Texture2D texture, bool drawCollisionCircle, float alpha);
+void DrawParticles(ParticleSystem *particlePool, Texture2D texture, float alpha, Rectangle view, int *numDrawn, int *numCulled);
 void DrawMSG(MSGSystem *msg);
 
-RenderTexture2D PaintCanvas(Texture2D atlas, enum BACKGROUND_TYPES bgLayer, Ground *groundPool, int relativeXPos);
+RenderTexture2D PaintCanvas(Texture2D atlas, ChunkPlan *plan);
+
+void GenerateBackground(ChunkPlan *plan, Rng *rng, enum BACKGROUND_STYLE bgStyle);
+void GenerateMidground(ChunkPlan *plan, Rng *rng, enum MIDDLEGROUND_STYLE mgStyle);
+void GenerateForeground(ChunkPlan *plan, Rng *rng, enum FOREGROUND_STYLE fgStyle, int relativeXPos);
 
-void GenerateBackground(RenderTexture2D canvas, Texture atlas, enum BACKGROUND_STYLE bgStyle);
-void GenerateMidground(RenderTexture2D canvas, Texture atlas, enum MIDDLEGROUND_STYLE mgStyle);
-void GenerateForeground(RenderTexture2D canvas, Ground *groundPool, Texture atlas, enum FOREGROUND_STYLE fgStyle, int relativeXPos);
+#include "explosionResolver.c" // Dependem das structs e dos headers acima
+#include "hitscan.c"
+#include "eventQueue.c"
+#include "commandBuffer.c"
 
 void TurnAround(Entity *ent) {
     ent->lowerAnimation.isFacingRight *= -1;
@@ -311,7 +410,10 @@ void MoveToTarget(Enemy *enemy) {
     enemy->entity.momentum.x += 2000;
 }
 
+// Só conta uma vez: o inimigo morto só fica DYING no próximo update dele, e até lá outra explosão pode alcançá-lo
 void KillEnemy(Player *player, Enemy *enemy, MSGSystem *msgSystem) {
+    if (enemy->isKilled) return;
+    enemy->isKilled = true;
     int value = 1000;
     Vector2 position = enemy->entity.position;
     position.y += 20;
@@ -320,21 +422,24 @@ void KillEnemy(Player *player, Enemy *enemy, MSGSystem *msgSystem) {
     enemy->entity.currentHP = 0;
 }
 
-void AttackTarget(Enemy *enemy, Entity *playerEntity, Bullet *bulletPool, enum ENEMY_CLASSES enemyClass, Sound *soundPool, Particle *particlePool) {
+void AttackTarget(Enemy *enemy, Entity *playerEntity, Bullet *bulletPool, enum ENEMY_CLASSES enemyClass, Sound *soundPool, ParticleSystem *particlePool) {
     // Atualizar estado
     LookAtTarget(enemy);
     switch (enemyClass)
     {
     case ASSASSIN:
-        PlaySoundMulti(soundPool[FX_SWORD]);
-        PlaySoundMulti(soundPool[FX_HURT]);
+        PlayFx(soundPool, FX_SWORD);
         CreateParticle(playerEntity->position, (Vector2) {0,0}, particlePool, BLOOD_SPILL, 2.5f, 0, (Vector2){1,1}, false, enemy->entity.lowerAnimation.isFacingRight);
-        playerEntity->currentHP-=30;
+        HurtEntity(playerEntity, soundPool, 30);
         break;
     case GUNNER:
-        PlaySoundMulti(soundPool[FX_MAGNUM]);
+        PlayFx(soundPool, FX_MAGNUM);
         CreateBullet(&(enemy->entity), bulletPool, MAGNUM, ENEMY);
         break;
+    case SNIPERSHOOTER:
+        PlayFx(soundPool, FX_MAGNUM);
+        CreateBullet(&(enemy->entity), bulletPool, SNIPER, ENEMY); // Hitscan, não ocupa a bulletsPool
+        break;
     default:
         break;
     }
@@ -343,7 +448,7 @@ void AttackTarget(Enemy *enemy, Entity *playerEntity, Bullet *bulletPool, enum E
     enemy->entity.velocity.x = 0;
 }
 
-void SteeringBehavior(Enemy *enemy, Player *player, Entity *playerEntity, Bullet *bulletPool, Sound *soundPool, Particle *particlePool, float delta, enum ENEMY_CLASSES enemyClass) {
+void SteeringBehavior(Enemy *enemy, Player *player, Entity *playerEntity, Bullet *bulletPool, Sound *soundPool, ParticleSystem *particlePool, float delta, enum ENEMY_CLASSES enemyClass) {
     Entity *eEnt = &(enemy->entity); // Pointer direto para a Entity do inimigo
     Entity *pEnt = &(player->entity); // Pointer direto para a Entity do player
     
@@ -404,14 +509,14 @@ void SteeringBehavior(Enemy *enemy, Player *player, Entity *playerEntity, Bullet
             if (enemy->behavior == NONE) { // Se não tiver target
                 if (enemy->timeSinceLastBehaviorChange >= enemy->behaviorChangeInterval) { // Controle de tempo para alterar comportamento
                     enemy->timeSinceLastBehaviorChange = 0;
-                    int random = GetRandomValue(1, 5); // 5 possibilidades. Precisar tunar para que o inimigo não se afaste tanto do spawn próprio
+                    int random = RngRange(&enemy->aiRng, 1, 5); // 5 possibilidades. Precisar tunar para que o inimigo não se afaste tanto do spawn próprio
                     if (random <= 1) { // 10%
                         // Mudar direção
                         TurnAround(eEnt);
                         eEnt->momentum.x = 0; // Parar
                         eEnt->velocity.x = 0; // Parar
                     } else { // 80%
-                        random = GetRandomValue(1,5);
+                        random = RngRange(&enemy->aiRng, 1,5);
                         // Alguma outra opção?
                         if (random <= 2) {// 20%
                             eEnt->momentum.x = 0; // Parar
@@ -469,7 +574,7 @@ void PlayEntityAnimation(Entity *entity, float delta, Animation *animation, floa
     }
 }
 
-void PhysicsAndGraphicsHandlers (Entity *entity, float delta, enum CHARACTER_STATE currentLowerState, enum CHARACTER_STATE currentUpperState, enum ENTITY_TYPES entityType, enum ENEMY_CLASSES enemyClass) {
+void PhysicsAndGraphicsHandlers (Entity *entity, float delta, enum CHARACTER_STATE currentLowerState, enum CHARACTER_STATE currentUpperState, bool animate) {
     Animation *upperAnimation = &(entity->upperAnimation);
     Animation *lowerAnimation = &(entity->lowerAnimation);
 
@@ -529,9 +634,7 @@ void PhysicsAndGraphicsHandlers (Entity *entity, float delta, enum CHARACTER_STA
         }
     }
 
-    int lAnimRow = 0;
-    int uAnimRow = 0;
-
+    if (!animate) return; // Longe do player: só física e estado, o quadro da animação fica parado
 
     if (currentLowerState != lowerAnimation->currentAnimationState) {
         lowerAnimation->timeSinceLastFrame = 0.0f;
@@ -541,131 +644,18 @@ void PhysicsAndGraphicsHandlers (Entity *entity, float delta, enum CHARACTER_STA
         upperAnimation->timeSinceLastFrame = 0.0f;
         upperAnimation->currentAnimationFrame = 0;
     }
-    switch (lowerAnimation->currentAnimationState)
-    {
-    case IDLE:
-        if (entityType == PLAYER) {
-            lAnimRow = PLAYER_LEGS_IDLE_ROW;
-            PlayEntityAnimation(entity, delta, lowerAnimation, PLAYER_LEGS_IDLE_NUM_FRAMES, true, false, -1, false, IDLE);
-        } else {
-            lAnimRow = entity->LEGS_IDLE_ROW;
-            PlayEntityAnimation(entity, delta, lowerAnimation, entity->LEGS_IDLE_NUM_FRAMES, true, false, -1, false, IDLE);
-        }
-        break;
-    case WALKING:
-        if (entityType == PLAYER) {
-            lAnimRow = PLAYER_LEGS_WALKING_ROW;
-            PlayEntityAnimation(entity, delta, lowerAnimation, PLAYER_LEGS_WALKING_NUM_FRAMES, true, false, -1, false, WALKING);
-        } else {
-            lAnimRow = entity->LEGS_WALKING_ROW;
-            PlayEntityAnimation(entity, delta, lowerAnimation, entity->LEGS_WALKING_NUM_FRAMES, true, false, -1, false, WALKING);
-        }
-        break;
-    case JUMPING:
-        if (entityType == PLAYER) {
-            lAnimRow = PLAYER_LEGS_JUMPING_ROW;
-            PlayEntityAnimation(entity, delta, lowerAnimation, PLAYER_LEGS_JUMPING_NUM_FRAMES, false, false, -1, false, JUMPING);
-        } else {
-            // Não tem animação para os inimigos... Usando idle
-            lAnimRow = entity->LEGS_IDLE_ROW;
-            PlayEntityAnimation(entity, delta, lowerAnimation, entity->LEGS_IDLE_NUM_FRAMES, true, false, -1, false, IDLE);
-        }
-        break;
-    case FALLING:
-        if (entityType == PLAYER) {
-            lAnimRow = PLAYER_LEGS_JUMPING_ROW;
-            PlayEntityAnimation(entity, delta, lowerAnimation, PLAYER_LEGS_JUMPING_NUM_FRAMES, false, true, PLAYER_LEGS_JUMPING_NUM_FRAMES, false, FALLING);
-        } else {
-            // Não tem animação para os inimigos... Usando idle
-            lAnimRow = entity->LEGS_IDLE_ROW;
-            PlayEntityAnimation(entity, delta, lowerAnimation, entity->LEGS_IDLE_NUM_FRAMES, true, false, -1, false, IDLE);
-        }
-        break;
-    case DYING:
-        if (entityType == PLAYER) {
-            lAnimRow = PLAYER_BODY_DYING_ROW;
-            PlayEntityAnimation(entity, delta, lowerAnimation, PLAYER_BODY_DYING_NUM_FRAMES, false, false, -1, false, DEAD);
-        } else {
-            lAnimRow = entity->BODY_DYING_ROW;
-            PlayEntityAnimation(entity, delta, lowerAnimation, entity->BODY_DYING_NUM_FRAMES, false, false, -1, false, DEAD);
-        }
-        break;
-    default:
-        break;
-    }
-    
-    int numOfFrames = 0;
-    switch (upperAnimation->currentAnimationState) {
-    case IDLE:
-        if (entityType == PLAYER) {
-            uAnimRow = PLAYER_UPPER_IDLE_ROW;
-            PlayEntityAnimation(entity, delta, upperAnimation, PLAYER_UPPER_IDLE_NUM_FRAMES, true, false, -1, false, IDLE);
-        } else {
-            uAnimRow = entity->UPPER_IDLE_ROW;
-            PlayEntityAnimation(entity, delta, upperAnimation, entity->UPPER_IDLE_NUM_FRAMES, true, false, -1, false, IDLE);
-        }
-        break;
-    case WALKING:
-        if (entityType == PLAYER) {
-            uAnimRow = PLAYER_UPPER_WALKING_ROW;
-            PlayEntityAnimation(entity, delta, upperAnimation, PLAYER_UPPER_WALKING_NUM_FRAMES, true, false, -1, false, WALKING);
-        } else {
-            uAnimRow = entity->UPPER_WALKING_ROW;
-            PlayEntityAnimation(entity, delta, upperAnimation, entity->UPPER_WALKING_NUM_FRAMES, true, false, -1, false, WALKING);
-        }
-        break;
-    case JUMPING:
-        if (entityType == PLAYER) {
-            uAnimRow = PLAYER_UPPER_JUMPING_ROW;
-            PlayEntityAnimation(entity, delta, upperAnimation, PLAYER_UPPER_JUMPING_NUM_FRAMES, false, false, -1, false, JUMPING);
-        } else {
-            // Não tem animção para os inimigos... usando idle
-            uAnimRow = entity->UPPER_IDLE_ROW;
-            PlayEntityAnimation(entity, delta, upperAnimation, entity->UPPER_IDLE_NUM_FRAMES, true, false, -1, false, IDLE);
-        }
-        break;
-    case FALLING:
-        if (entityType == PLAYER) {
-            uAnimRow = PLAYER_UPPER_JUMPING_ROW;
-            PlayEntityAnimation(entity, delta, upperAnimation, PLAYER_UPPER_JUMPING_NUM_FRAMES, false, true, PLAYER_UPPER_JUMPING_NUM_FRAMES, false, FALLING);
-        } else {
-            // Não tem animação para os inimigos... usando idle
-            uAnimRow = entity->UPPER_IDLE_ROW;
-            PlayEntityAnimation(entity, delta, upperAnimation, entity->UPPER_IDLE_NUM_FRAMES, true, false, -1, false, IDLE);
-        }
-        break;
-    case ATTACKING:
-        if (entityType == PLAYER) {
-            if (entity->upPressed) {
-                uAnimRow = PLAYER_UPPER_ATTACKING_45U_ROW;
-                numOfFrames = PLAYER_UPPER_ATTACKING_45U_NUM_FRAMES;
-            } else if (entity->downPressed) {
-                uAnimRow = PLAYER_UPPER_ATTACKING_45D_ROW;
-                numOfFrames = PLAYER_UPPER_ATTACKING_45D_NUM_FRAMES;
-            } else {
-                uAnimRow = PLAYER_UPPER_ATTACKING_ROW;
-                numOfFrames = PLAYER_UPPER_ATTACKING_NUM_FRAMES;
-            }
-            PlayEntityAnimation(entity, delta, upperAnimation, numOfFrames, false, false, -1, true, IDLE);
-        } else {
-            uAnimRow = entity->UPPER_ATTACKING_ROW;
-            PlayEntityAnimation(entity, delta, upperAnimation, entity->UPPER_ATTACKING_NUM_FRAMES, false, false, -1, true, IDLE);
-        }
-        break;
-    case DYING:
-        uAnimRow = -1; // A animação é gerida apenas por "lowerAnimation"
-        break;
-    case THROWING:
-        if (entityType == PLAYER) {
-            uAnimRow = PLAYER_UPPER_THROWING_ROW;
-            PlayEntityAnimation(entity, delta, upperAnimation, PLAYER_UPPER_THROWING_NUM_FRAMES, false, false, -1, true, IDLE);
-        } else {
-            // Não tem animação para o inimigo...
-        }
-        break;
-    default:
-        break;
-    }
+
+    // Estado de cada metade do corpo -> clip da classe
+    const AnimationClip *lowerClip = &entity->clips->lower[lowerAnimation->currentAnimationState];
+    const AnimationClip *upperClip = &entity->clips->upper[upperAnimation->currentAnimationState];
+    if (upperAnimation->currentAnimationState == ATTACKING)
+        upperClip = &entity->clips->upperAttacking[entity->upPressed ? UP45 : (entity->downPressed ? DOWN45 : FORWARD)];
+    int lAnimRow = lowerClip->row;
+    int uAnimRow = upperClip->row;
+    if (lowerClip->numFrames > 0)
+        PlayEntityAnimation(entity, delta, lowerAnimation, lowerClip->numFrames, lowerClip->isLoopable, lowerClip->isFixed, lowerClip->fixedFrame, lowerClip->transitToAnotherState, lowerClip->nextState);
+    if (upperClip->numFrames > 0)
+        PlayEntityAnimation(entity, delta, upperAnimation, upperClip->numFrames, upperClip->isLoopable, upperClip->isFixed, upperClip->fixedFrame, upperClip->transitToAnotherState, upperClip->nextState);
 
     entity->lowerAnimation.currentAnimationFrameRect.x = (float)entity->lowerAnimation.currentAnimationFrame * entity->lowerAnimation.animationFrameWidth;
     entity->lowerAnimation.currentAnimationFrameRect.y = lAnimRow * entity->lowerAnimation.animationFrameHeight;
@@ -676,12 +666,16 @@ void PhysicsAndGraphicsHandlers (Entity *entity, float delta, enum CHARACTER_STA
     entity->upperAnimation.currentAnimationFrameRect.width = entity->lowerAnimation.isFacingRight * entity->upperAnimation.animationFrameWidth;
 }
 
-void EntityCollisionHandler(Player *player, Entity *entity, Enemy *enemyPool, Ground *ground, EnvProps *envProp, Particle *particlePool, Sound *soundPool, MSGSystem *msgSystem, float delta, int difficulty) {
+void EntityCollisionHandler(Player *player, Entity *entity, Enemy *enemyPool, Ground *ground, EnvProps *envProp, ParticleSystem *particlePool, Sound *soundPool, MSGSystem *msgSystem, float delta, int difficulty) {
+    ProfileBegin(PROF_COLLISION);
     // Colisão com grounds                                            ///////////////////////////////////////////////////////////////////////
     int hitObstacle = 0;
     bool initIsGrounded = entity->isGrounded; // usado para o som da entidade batendo no chão
-    for (int i = 0; i < maxNumGrounds; i++)
+    int candidates[spatialMaxResults];
+    int numCandidates = SpatialHashQueryRect(PoolGrid(ground), SpatialSweptRect(entity->collisionBox, entity->velocity, delta), candidates, spatialMaxResults);
+    for (int n = 0; n < numCandidates; n++)
     {
+        int i = candidates[n];
         Ground *curGround = ground + i;
         Vector2 *p = &(entity->position);
         if (curGround->isActive) {
@@ -746,14 +740,16 @@ void EntityCollisionHandler(Player *player, Entity *entity, Enemy *enemyPool, Gr
 
     if (abs(player->entity.position.x - entity->position.x) < 1.1f*screenWidth) {
         if (initIsGrounded != entity->isGrounded && (entity->isGrounded)) {
-            PlaySoundMulti(soundPool[FX_ENTITY_LANDING]);
+            PlayFx(soundPool, FX_ENTITY_LANDING);
         }
     }
 
     // Colisão com Props coletáveis                                  ///////////////////////////////////////////////////////////////////////
     if (entity->type == PLAYER) {
-        for (int i = 0; i < maxNumEnvProps; i++)
+        numCandidates = SpatialHashQueryRect(PoolGrid(envProp), SpatialSweptRect(entity->collisionBox, entity->velocity, delta), candidates, spatialMaxResults);
+        for (int n = 0; n < numCandidates; n++)
         {
+            int i = candidates[n];
             EnvProps *curProp = envProp + i;
             if (curProp->isActive) {
                 Rectangle *eCol = &(entity->collisionBox);
@@ -788,57 +784,67 @@ void EntityCollisionHandler(Player *player, Entity *entity, Enemy *enemyPool, Gr
         }
     }
 
+    ProfileEnd(PROF_COLLISION);
+}
+
+// Retângulo andando motion contra o corpo de um personagem (caixa de colisão ou cabeça)
+bool SweepRectBody(Rectangle box, Vector2 motion, Rectangle body, Circle head, float *tHit) {
+    float tBody, tHead;
+    Vector2 normal;
+    bool hitBody = SweepRectRect(box, motion, body, &tBody, &normal);
+    bool hitHead = SweepCircleRect(head.center, head.radius, (Vector2) {-motion.x, -motion.y}, box, &tHead, &normal); // Movimento relativo
+    if (!hitBody && !hitHead) return false;
+    *tHit = (hitBody && hitHead ? fminf(tBody, tHead) : (hitBody ? tBody : tHead));
+    return true;
 }
 
+// O dano (e o som) é aplicado no DispatchEvents, junto com os outros danos do passo
 void HurtEntity(Entity *dstEntity, Sound *soundPool, int damage) {
-    PlaySoundMulti(soundPool[FX_HURT]);
-    dstEntity->currentHP -= damage;
+    if (DeferHurt(dstEntity, damage)) return; // Dentro de um job
+    QueueHurt(dstEntity, damage);
 }
 
-void ExplosionAOE(Player *player, MSGSystem *msgSystem, EnvProps *envPropPool, Enemy *enemyPool, Ground *groundPool, Particle *particlePool, Sound *soundPool, int explosionRadius, float energy, Vector2 centerOfExplosion, enum ENTITY_TYPES srcEntity, int difficulty) {
-    int maxCount = 0;
-    maxCount = fmax(maxNumGrounds, maxNumGrenade);
-    maxCount = fmax(maxCount, maxNumEnvProps);
-    maxCount = fmax(maxCount, maxNumEnemies);
-    maxCount = fmax(maxCount, maxNumBullets);
-    for (int i = 0; i < maxCount; i++) {
-        if (i < maxNumEnvProps) {
-            EnvProps *curEnvProp = envPropPool + i;
-            // Props
-            if (curEnvProp->isActive && curEnvProp->isDestroyable) {
-                if (CheckCollisionCircleRec(centerOfExplosion, explosionRadius, curEnvProp->collisionRect)) {
-                    DestroyEnvProp(player, enemyPool, envPropPool, groundPool, particlePool, soundPool, msgSystem, i, difficulty);
-                }
+void ExplosionAOE(Player *player, MSGSystem *msgSystem, EnvProps *envPropPool, Enemy *enemyPool, Ground *groundPool, ParticleSystem *particlePool, Sound *soundPool, int explosionRadius, float energy, Vector2 centerOfExplosion, enum ENTITY_TYPES srcEntity, int difficulty) {
+    int candidates[spatialMaxResults];
+    int numCandidates = SpatialHashQueryCircle(PoolGrid(envPropPool), centerOfExplosion, explosionRadius, candidates, spatialMaxResults);
+    for (int n = 0; n < numCandidates; n++) {
+        int i = candidates[n];
+        EnvProps *curEnvProp = envPropPool + i;
+        // Props
+        if (curEnvProp->isActive && curEnvProp->isDestroyable) {
+            if (CheckCollisionCircleRec(centerOfExplosion, explosionRadius, curEnvProp->collisionRect)) {
+                DestroyEnvProp(player, enemyPool, envPropPool, groundPool, particlePool, soundPool, msgSystem, i, difficulty);
             }
         }
+    }
 
-        if (i < maxNumEnemies) {
-            Enemy *curEnemy = enemyPool + i;
-            // Enemy
-            if (curEnemy->entity.lowerAnimation.currentAnimationState != DYING) {
-                if (CheckCollisionCircleRec(centerOfExplosion, explosionRadius, curEnemy->entity.collisionBox)) {
-                    KillEnemy(player, curEnemy, msgSystem);
-                    curEnemy->entity.currentHP = 0;
-                }
+    numCandidates = SpatialHashQueryCircle(PoolGrid(enemyPool), centerOfExplosion, explosionRadius, candidates, spatialMaxResults);
+    EnemyCollider *colliders = (EnemyCollider *)PoolHotData(enemyPool);
+    for (int n = 0; n < numCandidates; n++) {
+        EnemyCollider *collider = colliders + candidates[n];
+        // Enemy (a struct inteira só é lida quando acerta)
+        if (collider->isHittable) {
+            if (CheckCollisionCircleRec(centerOfExplosion, explosionRadius, collider->collisionBox)) {
+                QueueKill(enemyPool + candidates[n]);
             }
         }
-
     }
 }
 
-void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enemy *enemyPool, int difficulty) {
+// Roda na thread do pipeline de chunks: só escreve no plano, a criação fica para o CommitChunk
+void PopulateChunk(ChunkPlan *plan, Rng *rng, int chunkId) {
     // chunkId -> posição do chunk para correto posicionamento
     int objAdditions = 0;
     int enemyAdditions = 0;
     // Popular com objetos
     int objProb = 60; // 5% de chance de ter um objeto
     int enemyProb = 70; // 15% de chance de ter um inimigo
-    if (GetRandomValue(1,100) <= objProb) {
+    if (RngRange(rng, 1,100) <= objProb) {
         objAdditions++;
         int obType;
-        int clusterType = GetRandomValue(PILE_OF_GARBAGE_S, PILE_OF_CRATE);
+        int clusterType = RngRange(rng, PILE_OF_GARBAGE_S, PILE_OF_CRATE);
         int rnd;
-        if (GetRandomValue(1,100) <= 3) { // 3% de chance
+        if (RngRange(rng, 1,100) <= 3) { // 3% de chance
             clusterType = COLLECTIBLE;
         }
 
@@ -847,7 +853,7 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
         int xOffset;
         int numRows = 2;
         enum OBJECTS_TYPES obj;
-        int w, h;
+        int w = 0, h = 0;
         int xPos;
         int pileMax;
         int rowHei[3];
@@ -861,22 +867,22 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
         case PILE_OF_GARBAGE_S:
             // amontoado pequeno de lixo (saco de lixo e caixa de papelão)
             numRows = 2;
-            xOffset = GetRandomValue(100, 700);
-            numObjRow = GetRandomValue(1,3);
+            xOffset = RngRange(rng, 100, 700);
+            numObjRow = RngRange(rng, 1,3);
             for (int j = 0; j < numRows; j++) {
                 xPos = chunkId*screenWidth + xOffset + j*w/2;
                 for (int i = 0; i < numObjRow; i++) {
-                    nextObj = GetRandomValue(1, 100);
+                    nextObj = RngRange(rng, 1, 100);
                     if (nextObj <= 60) { // 60% saco de lixo
-                        obj = GetRandomValue(GARBAGE_BAG1, GARBAGE_BAG2);
+                        obj = RngRange(rng, GARBAGE_BAG1, GARBAGE_BAG2);
                         w = (obj == GARBAGE_BAG1 ? 100 : 80);
                         h = (obj == GARBAGE_BAG1 ? 100 : 80);
                     } else {
-                        obj = GetRandomValue(CARD_CRATE1, CARD_CRATE3);
+                        obj = RngRange(rng, CARD_CRATE1, CARD_CRATE3);
                         w = 130;
                         h = 130;
                     }
-                    CreateEnvProp(envPropsPool, groundPool, obj, (Vector2) {xPos, rowHei[j] - h}, w, h);
+                    PlanProp(plan, obj, (Vector2) {xPos, rowHei[j] - h}, w, h);
                     xPos+=w;
                 }
             }
@@ -885,12 +891,12 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
             numRows = 2;
             objLim1 = 0;
             objLim2 = 0;
-            xOffset = GetRandomValue(100, 500);
-            numObjRow = GetRandomValue(2,4);
+            xOffset = RngRange(rng, 100, 500);
+            numObjRow = RngRange(rng, 2,4);
             for (int j = 0; j < numRows; j++) {
                 xPos = chunkId*screenWidth + xOffset + j*w/2;
                 for (int i = 0; i < numObjRow; i++) {
-                    nextObj = GetRandomValue(1, 100);
+                    nextObj = RngRange(rng, 1, 100);
                     if (j == 0) {
                         if (nextObj <= 35) { // 20% container
                             if (objLim1 < 1) {
@@ -898,12 +904,12 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
                                 w = 220;
                                 h = 220;
                             } else {
-                                if (GetRandomValue(1,2) == 1) {
-                                    obj = GetRandomValue(GARBAGE_BAG1, GARBAGE_BAG2);
+                                if (RngRange(rng, 1,2) == 1) {
+                                    obj = RngRange(rng, GARBAGE_BAG1, GARBAGE_BAG2);
                                     w = (obj == GARBAGE_BAG1 ? 100 : 80);
                                     h = (obj == GARBAGE_BAG1 ? 100 : 80);
                                 } else {
-                                    obj = GetRandomValue(CARD_CRATE1, CARD_CRATE3);
+                                    obj = RngRange(rng, CARD_CRATE1, CARD_CRATE3);
                                     w = 130;
                                     h = 130;
                                 }
@@ -913,12 +919,12 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
                             w = 130;
                             h = 130;
                         } else {
-                            if (GetRandomValue(1,2) == 1) {
-                                obj = GetRandomValue(GARBAGE_BAG1, GARBAGE_BAG2);
+                            if (RngRange(rng, 1,2) == 1) {
+                                obj = RngRange(rng, GARBAGE_BAG1, GARBAGE_BAG2);
                                 w = (obj == GARBAGE_BAG1 ? 100 : 80);
                                 h = (obj == GARBAGE_BAG1 ? 100 : 80);
                             } else {
-                                obj = GetRandomValue(CARD_CRATE1, CARD_CRATE3);
+                                obj = RngRange(rng, CARD_CRATE1, CARD_CRATE3);
                                 w = 130;
                                 h = 130;
                             }
@@ -930,29 +936,29 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
                                 w = 130;
                                 h = 130;
                             } else {
-                                if (GetRandomValue(1,2) == 1) {
-                                    obj = GetRandomValue(GARBAGE_BAG1, GARBAGE_BAG2);
+                                if (RngRange(rng, 1,2) == 1) {
+                                    obj = RngRange(rng, GARBAGE_BAG1, GARBAGE_BAG2);
                                     w = (obj == GARBAGE_BAG1 ? 100 : 80);
                                     h = (obj == GARBAGE_BAG1 ? 100 : 80);
                                 } else {
-                                    obj = GetRandomValue(CARD_CRATE1, CARD_CRATE3);
+                                    obj = RngRange(rng, CARD_CRATE1, CARD_CRATE3);
                                     w = 130;
                                     h = 130;
                                 }
                             }
                         } else {
-                            if (GetRandomValue(1,2) == 1) {
-                                obj = GetRandomValue(GARBAGE_BAG1, GARBAGE_BAG2);
+                            if (RngRange(rng, 1,2) == 1) {
+                                obj = RngRange(rng, GARBAGE_BAG1, GARBAGE_BAG2);
                                 w = (obj == GARBAGE_BAG1 ? 100 : 80);
                                 h = (obj == GARBAGE_BAG1 ? 100 : 80);
                             } else {
-                                obj = GetRandomValue(CARD_CRATE1, CARD_CRATE3);
+                                obj = RngRange(rng, CARD_CRATE1, CARD_CRATE3);
                                 w = 130;
                                 h = 130;
                             }
                         }
                     }
-                    CreateEnvProp(envPropsPool, groundPool, obj, (Vector2) {xPos, rowHei[j] - h}, w, h);
+                    PlanProp(plan, obj, (Vector2) {xPos, rowHei[j] - h}, w, h);
                     if (obj == TRASH_CONTAINER) objLim1 = 1;
                     if (obj == TRASH_BIN) objLim2++;
                     xPos+=w;
@@ -963,24 +969,24 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
             numRows = 2;
             objLim1 = 0;
             objLim2 = 0;
-            xOffset = GetRandomValue(100, 500);
-            numObjRow = GetRandomValue(1,2);
+            xOffset = RngRange(rng, 100, 500);
+            numObjRow = RngRange(rng, 1,2);
             for (int j = 0; j < numRows; j++) {
                 xPos = chunkId*screenWidth + xOffset + j*w/2;
                 for (int i = 0; i < numObjRow+j; i++) {
-                    nextObj = GetRandomValue(1, 100);
+                    nextObj = RngRange(rng, 1, 100);
                     if (nextObj <= 10) { // 10% explosivo
                         if (objLim1 < 1) {
                             obj = EXPLOSIVE_BARREL;
                             w = 130;
                             h = 130;
                         } else {
-                            if (GetRandomValue(1,2) == 1) {
-                                obj = GetRandomValue(GARBAGE_BAG1, GARBAGE_BAG2);
+                            if (RngRange(rng, 1,2) == 1) {
+                                obj = RngRange(rng, GARBAGE_BAG1, GARBAGE_BAG2);
                                 w = (obj == GARBAGE_BAG1 ? 100 : 80);
                                 h = (obj == GARBAGE_BAG1 ? 100 : 80);
                             } else {
-                                obj = GetRandomValue(CARD_CRATE1, CARD_CRATE3);
+                                obj = RngRange(rng, CARD_CRATE1, CARD_CRATE3);
                                 w = 130;
                                 h = 130;
                             }
@@ -990,19 +996,19 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
                         w = 140;
                         h = 140;
                     } else if (nextObj <= 90) { // deixando 10% sem nada
-                        if (GetRandomValue(1,2) == 1) {
-                            obj = GetRandomValue(GARBAGE_BAG1, GARBAGE_BAG2);
+                        if (RngRange(rng, 1,2) == 1) {
+                            obj = RngRange(rng, GARBAGE_BAG1, GARBAGE_BAG2);
                             w = (obj == GARBAGE_BAG1 ? 100 : 80);
                             h = (obj == GARBAGE_BAG1 ? 100 : 80);
                         } else {
-                            obj = GetRandomValue(CARD_CRATE1, CARD_CRATE3);
+                            obj = RngRange(rng, CARD_CRATE1, CARD_CRATE3);
                             w = 130;
                             h = 130;
                         }
                     } else {
                         obj = -1;
                     }
-                    if (obj != -1) CreateEnvProp(envPropsPool, groundPool, obj, (Vector2) {xPos, rowHei[j] - h}, w, h);
+                    if (obj != -1) PlanProp(plan, obj, (Vector2) {xPos, rowHei[j] - h}, w, h);
                     if (obj == EXPLOSIVE_BARREL) objLim1 = 1;
                     xPos+=w;
                 }
@@ -1012,24 +1018,24 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
             numRows = 3;
             objLim1 = 0;
             objLim2 = 0;
-            xOffset = GetRandomValue(100, 500);
-            numObjRow = GetRandomValue(1,2);
+            xOffset = RngRange(rng, 100, 500);
+            numObjRow = RngRange(rng, 1,2);
             for (int j = 0; j < numRows; j++) {
-                xPos = chunkId*screenWidth + xOffset + j*w/2*(GetRandomValue(1,2) == 1 ? -1 : 1);
+                xPos = chunkId*screenWidth + xOffset + j*w/2*(RngRange(rng, 1,2) == 1 ? -1 : 1);
                 for (int i = 0; i < numObjRow; i++) {
-                    nextObj = GetRandomValue(1, 100);
+                    nextObj = RngRange(rng, 1, 100);
                     if (nextObj <= 20) { // 20% explosivo
                         if (objLim1 < 1) {
                             obj = EXPLOSIVE_BARREL;
                             w = 130;
                             h = 130;
                         } else {
-                            if (GetRandomValue(1,2) == 1) {
-                                obj = GetRandomValue(GARBAGE_BAG1, GARBAGE_BAG2);
+                            if (RngRange(rng, 1,2) == 1) {
+                                obj = RngRange(rng, GARBAGE_BAG1, GARBAGE_BAG2);
                                 w = (obj == GARBAGE_BAG1 ? 100 : 80);
                                 h = (obj == GARBAGE_BAG1 ? 100 : 80);
                             } else {
-                                obj = GetRandomValue(CARD_CRATE1, CARD_CRATE3);
+                                obj = RngRange(rng, CARD_CRATE1, CARD_CRATE3);
                                 w = 130;
                                 h = 130;
                             }
@@ -1039,19 +1045,19 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
                         w = 140;
                         h = 140;
                     } else if (nextObj <= 90) { // deixando 10% sem nada
-                        if (GetRandomValue(1,2) == 1) {
-                            obj = GetRandomValue(GARBAGE_BAG1, GARBAGE_BAG2);
+                        if (RngRange(rng, 1,2) == 1) {
+                            obj = RngRange(rng, GARBAGE_BAG1, GARBAGE_BAG2);
                             w = (obj == GARBAGE_BAG1 ? 100 : 80);
                             h = (obj == GARBAGE_BAG1 ? 100 : 80);
                         } else {
-                            obj = GetRandomValue(CARD_CRATE1, CARD_CRATE3);
+                            obj = RngRange(rng, CARD_CRATE1, CARD_CRATE3);
                             w = 130;
                             h = 130;
                         }
                     } else {
                         obj = -1;
                     }
-                    if (obj != -1) CreateEnvProp(envPropsPool, groundPool, obj, (Vector2) {xPos, rowHei[j] - h}, w, h);
+                    if (obj != -1) PlanProp(plan, obj, (Vector2) {xPos, rowHei[j] - h}, w, h);
                     if (obj == EXPLOSIVE_BARREL) objLim1 = 1;
                     xPos+=w;
                 }
@@ -1063,22 +1069,22 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
             objLim2 = 0;
             hasAbove = 0;
             pileMax = 1;
-            xOffset = GetRandomValue(100, 500);
-            numObjRow = GetRandomValue(1,2);
-            if (GetRandomValue(1,4) < 2) {
+            xOffset = RngRange(rng, 100, 500);
+            numObjRow = RngRange(rng, 1,2);
+            if (RngRange(rng, 1,4) < 2) {
                 pileMax++;
             }
             for (int j = 0; j < numRows; j++) {
-            xPos = chunkId*screenWidth + xOffset + j*w/2*(GetRandomValue(1,2) == 1 ? -1 : 1);
+            xPos = chunkId*screenWidth + xOffset + j*w/2*(RngRange(rng, 1,2) == 1 ? -1 : 1);
                 for (int i = 0; i < numObjRow; i++) {
                     hasAbove = 0;
-                    nextObj = GetRandomValue(1, 100);
+                    nextObj = RngRange(rng, 1, 100);
                         if (nextObj <= 40) { // 40% de ter a caixa
                             obj = METAL_CRATE;
                             w = 130;
                             h = 130;
                             if (pileMax == 2) {
-                                if (GetRandomValue(1,5) < 5) {
+                                if (RngRange(rng, 1,5) < 5) {
                                     hasAbove = 1;
                                 }
                             }
@@ -1087,7 +1093,7 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
                             w = 140;
                             h = 140;
                             if (pileMax == 2) {
-                                if (GetRandomValue(1,5) < 5) {
+                                if (RngRange(rng, 1,5) < 5) {
                                     hasAbove = 1;
                                 }
                             }
@@ -1095,10 +1101,10 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
                             obj = -1;
                         }
                     if (obj != -1) {
-                        CreateEnvProp(envPropsPool, groundPool, obj, (Vector2) {xPos, rowHei[j] - h}, w, h);
+                        PlanProp(plan, obj, (Vector2) {xPos, rowHei[j] - h}, w, h);
                         if (hasAbove == 1) {
                             if (j == 0) {
-                                CreateEnvProp(envPropsPool, groundPool, obj, (Vector2) {xPos, rowHei[j] - 2*h-2}, w, h);
+                                PlanProp(plan, obj, (Vector2) {xPos, rowHei[j] - 2*h-2}, w, h);
                             }
                         }
                     } 
@@ -1111,13 +1117,13 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
             objLim2 = 0;
             hasAbove = 0;
             pileMax = 1;
-            xOffset = GetRandomValue(100, 500);
-            numObjRow = GetRandomValue(0,2);
-            obj = (GetRandomValue(1,2) == 1 ? AMMO_CRATE : HP_CRATE);
+            xOffset = RngRange(rng, 100, 500);
+            numObjRow = RngRange(rng, 0,2);
+            obj = (RngRange(rng, 1,2) == 1 ? AMMO_CRATE : HP_CRATE);
             w = 130;
             h = 130;
-            xPos = chunkId*screenWidth + xOffset + numObjRow*w/2*(GetRandomValue(1,2) == 1 ? -1 : 1);
-            CreateEnvProp(envPropsPool, groundPool, obj, (Vector2) {xPos, rowHei[numObjRow] - h}, w, h);
+            xPos = chunkId*screenWidth + xOffset + numObjRow*w/2*(RngRange(rng, 1,2) == 1 ? -1 : 1);
+            PlanProp(plan, obj, (Vector2) {xPos, rowHei[numObjRow] - h}, w, h);
             break;
         default:
             break;
@@ -1125,12 +1131,29 @@ void PopulateChunk(int chunkId, EnvProps *envPropsPool, Ground *groundPool, Enem
     }
 
     if (chunkId != 0) {
-        for(int i = 0; i < (difficulty+1); i++){
-            if (GetRandomValue(1,100) <= enemyProb) {
+        // Sorteia todas as tentativas, a dificuldade na hora do CommitChunk decide quantas são usadas
+        for(int i = 0; i < chunkMaxEnemySlots; i++){
+            ChunkEnemy *enemy = &plan->enemies[i];
+            enemy->spawn = (RngRange(rng, 1,100) <= enemyProb);
+            if (enemy->spawn) {
                 enemyAdditions++;
-                int enClass = GetRandomValue(ASSASSIN, GUNNER);
-                CreateEnemy(enemyPool, enClass, (Vector2) {chunkId*screenWidth + GetRandomValue(50, 500), screenHeight-GetRandomValue(160,screenHeight)}, 122, 122);
+                enemy->enemyClass = RngRange(rng, ASSASSIN, GUNNER);
+                enemy->position = (Vector2) {chunkId*screenWidth + RngRange(rng, 50, 500), screenHeight-RngRange(rng, 160,screenHeight)};
             }
         }
     }
 }
+
+// Cria no mundo o conteúdo planejado do chunk (thread principal)
+void CommitChunk(ChunkPlan *plan, EnvProps *envPropsPool, Ground *groundPool, Enemy *enemyPool, int difficulty) {
+    for (int i = 0; i < plan->numGrounds; i++)
+        CreateGround(groundPool, (Vector2) {plan->grounds[i].x, plan->grounds[i].y}, plan->grounds[i].width, plan->grounds[i].height, true, false, false, true, false, -1);
+    for (int i = 0; i < plan->numProps; i++)
+        CreateEnvProp(envPropsPool, groundPool, plan->props[i].type, plan->props[i].position, plan->props[i].width, plan->props[i].height);
+    if (plan->layer == BACKGROUND && plan->chunkId != 0) {
+        for (int i = 0; i < difficulty+1 && i < chunkMaxEnemySlots; i++) {
+            if (plan->enemies[i].spawn)
+                CreateEnemy(enemyPool, plan->enemies[i].enemyClass, plan->enemies[i].position, 122, 122);
+        }
+    }
+}
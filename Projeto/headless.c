@@ -0,0 +1,343 @@
+// Modo headless: roda a simulação do jogo sem janela, GPU, áudio ou raylib.
+// Usado para medir o custo do update e reproduzir partidas de forma automática.
+//
+// Compilar:  gcc main.c -DHEADLESS -Iraylib -o headless -lm -pthread
+// Executar:  ./headless --frames 36000 --seed 42 --script input.txt
+// Replays:   ./headless --record partida.rpl    grava uma partida (até o player morrer ou acabarem os frames)
+//            ./headless --replay partida.rpl    reproduz a partida na velocidade máxima, com a seed do arquivo
+// Profiler:  ./headless --trace trace.json      grava os últimos frames no formato de trace do Chrome
+// Threads:   ./headless --threads 4             threads do sistema de jobs (padrão: uma por núcleo). O resultado é o mesmo com qualquer número
+//
+// As funções da raylib usadas pela simulação são substituídas abaixo:
+// colisões e câmera têm a mesma lógica da raylib, desenho e som não fazem nada.
+// O teclado vem de um script com linhas no formato "<frames> TECLA TECLA ...",
+// ex: "30 RIGHT SPACE" segura RIGHT e SPACE por 30 frames. O script repete ao acabar.
+#include <time.h>
+
+#define headlessMaxScriptSteps 256
+#define headlessMaxKeysPerStep 8
+
+typedef struct headlessStep {
+    int frames;
+    int numKeys;
+    int keys[headlessMaxKeysPerStep];
+} HeadlessStep;
+
+typedef struct headlessInput {
+    HeadlessStep steps[headlessMaxScriptSteps];
+    int numSteps;
+    int currentStep;
+    int framesInStep;
+    bool keyDown[512];
+    bool keyDownPrev[512];
+} HeadlessInput;
+
+static HeadlessInput headlessInput;
+
+// Script padrão: corre pra direita, pula, atira e joga granadas
+static const char *headlessDefaultScript =
+    "40 RIGHT\n"
+    "1 RIGHT R\n"
+    "5 RIGHT\n"
+    "1 RIGHT R\n"
+    "20 RIGHT SPACE\n"
+    "1 T\n"
+    "10 RIGHT\n"
+    "1 R\n"
+    "8 LEFT\n"
+    "1 LEFT R\n"
+    "15 RIGHT UP\n"
+    "1 RIGHT R\n"
+    "10 RIGHT DOWN\n";
+
+//------------------------------------------------------------------------------------
+// Substitutos da raylib
+//------------------------------------------------------------------------------------
+bool CheckCollisionRecs(Rectangle rec1, Rectangle rec2) {
+    return (rec1.x < (rec2.x + rec2.width) && (rec1.x + rec1.width) > rec2.x) &&
+           (rec1.y < (rec2.y + rec2.height) && (rec1.y + rec1.height) > rec2.y);
+}
+
+bool CheckCollisionCircles(Vector2 center1, float radius1, Vector2 center2, float radius2) {
+    float dx = center2.x - center1.x;
+    float dy = center2.y - center1.y;
+    return sqrtf(dx*dx + dy*dy) <= (radius1 + radius2);
+}
+
+bool CheckCollisionCircleRec(Vector2 center, float radius, Rectangle rec) {
+    int recCenterX = (int)(rec.x + rec.width/2.0f);
+    int recCenterY = (int)(rec.y + rec.height/2.0f);
+
+    float dx = fabsf(center.x - (float)recCenterX);
+    float dy = fabsf(center.y - (float)recCenterY);
+
+    if (dx > (rec.width/2.0f + radius)) return false;
+    if (dy > (rec.height/2.0f + radius)) return false;
+    if (dx <= (rec.width/2.0f)) return true;
+    if (dy <= (rec.height/2.0f)) return true;
+
+    float cornerDistanceSq = (dx - rec.width/2.0f)*(dx - rec.width/2.0f) + (dy - rec.height/2.0f)*(dy - rec.height/2.0f);
+    return cornerDistanceSq <= (radius*radius);
+}
+
+Vector2 GetWorldToScreen2D(Vector2 position, Camera2D camera) {
+    float rad = camera.rotation*DEG2RAD;
+    float x = (position.x - camera.target.x)*camera.zoom;
+    float y = (position.y - camera.target.y)*camera.zoom;
+    return (Vector2){ x*cosf(rad) - y*sinf(rad) + camera.offset.x, x*sinf(rad) + y*cosf(rad) + camera.offset.y };
+}
+
+Vector2 GetScreenToWorld2D(Vector2 position, Camera2D camera) {
+    float rad = -camera.rotation*DEG2RAD;
+    float x = position.x - camera.offset.x, y = position.y - camera.offset.y;
+    return (Vector2){ (x*cosf(rad) - y*sinf(rad))/camera.zoom + camera.target.x, (x*sinf(rad) + y*cosf(rad))/camera.zoom + camera.target.y };
+}
+
+float GetFrameTime(void) { return fixedTimeStep; }
+
+double GetTime(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec*1e-9;
+}
+
+// Só as dimensões são usadas pela simulação (posicionamento dos chunks). O id é único, como o do framebuffer
+RenderTexture2D LoadRenderTexture(int width, int height) {
+    static unsigned int nextId = 1;
+    RenderTexture2D target = { 0 };
+    target.id = nextId++;
+    target.texture.id = target.id; // Cada canvas é uma textura diferente para o batch de sprites
+    target.texture.width = width;
+    target.texture.height = height;
+    return target;
+}
+void UnloadRenderTexture(RenderTexture2D target) { }
+// Assets: o jogo sem janela não carrega nada (o cache de assets só é usado no main do jogo)
+Texture2D LoadTexture(const char *fileName) { return (Texture2D) { 0 }; }
+void UnloadTexture(Texture2D texture) { }
+Sound LoadSound(const char *fileName) { return (Sound) { 0 }; }
+void UnloadSound(Sound sound) { }
+Image LoadImage(const char *fileName) { return (Image) { 0 }; }
+void UnloadImage(Image image) { }
+Texture2D LoadTextureFromImage(Image image) { return (Texture2D) { 0 }; }
+Wave LoadWave(const char *fileName) { return (Wave) { 0 }; }
+void UnloadWave(Wave wave) { }
+Sound LoadSoundFromWave(Wave wave) { return (Sound) { 0 }; }
+int GetPixelDataSize(int width, int height, int format) { return 0; }
+void TraceLog(int logLevel, const char *text, ...) { }
+void BeginTextureMode(RenderTexture2D target) { }
+void EndTextureMode(void) { }
+
+void ClearBackground(Color color) { }
+Color ColorAlpha(Color color, float alpha) { color.a = (unsigned char)(alpha*255); return color; }
+Color GetColor(int hexValue) { return (Color){ (hexValue >> 24) & 0xFF, (hexValue >> 16) & 0xFF, (hexValue >> 8) & 0xFF, hexValue & 0xFF }; }
+void DrawCircle(int centerX, int centerY, float radius, Color color) { }
+void DrawRectangle(int posX, int posY, int width, int height, Color color) { }
+void DrawRectangleRec(Rectangle rec, Color color) { }
+void DrawTextureRec(Texture2D texture, Rectangle source, Vector2 position, Color tint) { }
+void DrawText(const char *text, int posX, int posY, int fontSize, Color color) { }
+int MeasureText(const char *text, int fontSize) { return 0; }
+void DrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint) { }
+const char *TextFormat(const char *text, ...) { return text; }
+void PlaySoundMulti(Sound sound) { }
+
+bool IsKeyDown(int key) { return (key >= 0 && key < 512) ? headlessInput.keyDown[key] : false; }
+bool IsKeyPressed(int key) { return (key >= 0 && key < 512) ? (headlessInput.keyDown[key] && !headlessInput.keyDownPrev[key]) : false; }
+
+//------------------------------------------------------------------------------------
+// Entrada por script
+//------------------------------------------------------------------------------------
+int HeadlessKeyFromName(const char *name) {
+    if (strcmp(name, "LEFT") == 0) return KEY_LEFT;
+    if (strcmp(name, "RIGHT") == 0) return KEY_RIGHT;
+    if (strcmp(name, "UP") == 0) return KEY_UP;
+    if (strcmp(name, "DOWN") == 0) return KEY_DOWN;
+    if (strcmp(name, "SPACE") == 0) return KEY_SPACE;
+    if (strlen(name) == 1 && name[0] >= 'A' && name[0] <= 'Z') return name[0]; // KEY_A..KEY_Z são os próprios caracteres
+    return -1;
+}
+
+void HeadlessParseScript(HeadlessInput *input, const char *script) {
+    char line[256];
+    input->numSteps = 0;
+
+    while (*script != '\0' && input->numSteps < headlessMaxScriptSteps) {
+        int len = strcspn(script, "\n");
+        if (len > (int)sizeof(line) - 1) len = sizeof(line) - 1;
+        memcpy(line, script, len);
+        line[len] = '\0';
+        script += strcspn(script, "\n");
+        if (*script == '\n') script++;
+
+        HeadlessStep step = { 0 };
+        char *token = strtok(line, " \t\r");
+        if (token == NULL || token[0] == '#') continue;
+        step.frames = atoi(token);
+        if (step.frames <= 0) continue;
+
+        while ((token = strtok(NULL, " \t\r")) != NULL && step.numKeys < headlessMaxKeysPerStep) {
+            int key = HeadlessKeyFromName(token);
+            if (key >= 0) step.keys[step.numKeys++] = key;
+            else fprintf(stderr, "headless: tecla desconhecida '%s'\n", token);
+        }
+        input->steps[input->numSteps++] = step;
+    }
+}
+
+bool HeadlessLoadScript(HeadlessInput *input, const char *fileName) {
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *script = (char *)malloc(size + 1);
+    size = fread(script, 1, size, file);
+    script[size] = '\0';
+    fclose(file);
+
+    HeadlessParseScript(input, script);
+    free(script);
+    return input->numSteps > 0;
+}
+
+// Avança o script em um frame e atualiza o estado das teclas
+void HeadlessUpdateInput(HeadlessInput *input) {
+    memcpy(input->keyDownPrev, input->keyDown, sizeof(input->keyDown));
+    memset(input->keyDown, 0, sizeof(input->keyDown));
+    if (input->numSteps == 0) return;
+
+    if (input->framesInStep >= input->steps[input->currentStep].frames) {
+        input->framesInStep = 0;
+        input->currentStep = (input->currentStep + 1)%input->numSteps;
+    }
+
+    HeadlessStep *step = &input->steps[input->currentStep];
+    for (int i = 0; i < step->numKeys; i++)
+        input->keyDown[step->keys[i]] = true;
+    input->framesInStep++;
+}
+
+//------------------------------------------------------------------------------------
+// Programa principal (o benchmark.c tem o seu)
+//------------------------------------------------------------------------------------
+#ifndef BENCHMARK
+int main(int argc, char **argv) {
+    long maxFrames = 36000;
+    uint64_t seed = 42;
+    const char *scriptFile = NULL;
+    const char *recordFile = NULL;
+    const char *replayFile = NULL;
+    const char *traceFile = NULL;
+    int numThreads = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) maxFrames = atol(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) scriptFile = argv[++i];
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordFile = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayFile = argv[++i];
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) traceFile = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) numThreads = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "uso: %s [--frames N] [--seed S] [--script arquivo] [--record arquivo | --replay arquivo] [--trace arquivo] [--threads N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (scriptFile != NULL) {
+        if (!HeadlessLoadScript(&headlessInput, scriptFile)) {
+            fprintf(stderr, "headless: não foi possível ler o script '%s'\n", scriptFile);
+            return 1;
+        }
+    } else {
+        HeadlessParseScript(&headlessInput, headlessDefaultScript);
+    }
+
+    // Os atlas e sons não são usados sem janela
+    Texture2D emptyAtlas = { 0 };
+    Sound *fxSoundPool = (Sound *)calloc(10, sizeof(Sound));
+
+    ReplayReader *replay = NULL;
+    if (replayFile != NULL) {
+        replay = ReplayOpenReader(replayFile);
+        if (replay == NULL) {
+            fprintf(stderr, "headless: não foi possível abrir o replay '%s'\n", replayFile);
+            return 1;
+        }
+        seed = replay->seed;
+        if (replay->numTicks > 0) maxFrames = replay->numTicks;
+    }
+
+    JobSystemInit(numThreads);
+    World world = {0};
+    InitWorld(&world, emptyAtlas, emptyAtlas, emptyAtlas, fxSoundPool, seed);
+    world.playback = replay;
+    if (recordFile != NULL) {
+        world.recorder = ReplayOpenWriter(recordFile, seed, (int)roundf(1.0f/fixedTimeStep));
+        if (world.recorder == NULL) {
+            fprintf(stderr, "headless: não foi possível criar o replay '%s'\n", recordFile);
+            return 1;
+        }
+    }
+    bool singleRun = (recordFile != NULL || replayFile != NULL); // Replays cobrem uma partida só
+    ProfileSetEnabled(traceFile != NULL);
+
+    int runs = 1;
+    long totalPoints = 0;
+    int chunksPlannedOnMainThread = 0; // Somado de cada partida (o pipeline é recriado no InitWorld)
+    long frame = 0;
+    double start = GetTime(); // Tempo real: com os jobs em paralelo, o clock() soma o tempo de todas as threads
+    clock_t cpuStart = clock();
+    for (; frame < maxFrames; frame++) {
+        // Um passo por frame, pelo mesmo caminho do jogo (com replay a entrada vem do arquivo)
+        HeadlessUpdateInput(&headlessInput);
+        ProfileBeginFrame();
+        AllocGuardBegin(); // Com -DALLOC_GUARD, aborta se o passo alocar memória
+        int numSteps = StepWorld(&world, fixedTimeStep, ReadKeyboardInput());
+        AllocGuardEnd();
+        if (numSteps == 0) break; // Fim do replay
+        ProfileEndFrame();
+
+        if (world.player.entity.lowerAnimation.currentAnimationState == DEAD && singleRun) {
+            frame++;
+            break;
+        }
+
+        // Reinicia a partida quando o player morre
+        if (world.player.entity.lowerAnimation.currentAnimationState == DEAD) {
+            totalPoints += world.player.points;
+            chunksPlannedOnMainThread += world.chunkPipeline->numPlannedOnMainThread;
+            UnloadWorld(&world);
+            InitWorld(&world, emptyAtlas, emptyAtlas, emptyAtlas, fxSoundPool, seed + runs); // Cada partida com a sua seed, reproduzível
+            runs++;
+        }
+    }
+    double elapsed = GetTime() - start;
+    double cpuTime = (double)(clock() - cpuStart)/CLOCKS_PER_SEC;
+    totalPoints += world.player.points;
+    chunksPlannedOnMainThread += world.chunkPipeline->numPlannedOnMainThread;
+
+    printf("frames: %ld\n", frame);
+    printf("runs: %d\n", runs);
+    printf("render textures loaded: %d\n", renderTexturePool.numLoads);
+    printf("chunks planned on main thread: %d\n", chunksPlannedOnMainThread);
+    printf("run arena: %zu KB of %zu KB\n", world.arena.highWater/1024, world.arena.capacity/1024);
+    printf("points: %ld\n", totalPoints);
+    printf("deferred commands: %ld in overflow blocks, %ld dropped\n", numCommandsOverflow, (long)atomic_load(&numCommandsDropped));
+    printf("events: %ld coalesced, %ld resolved on overflow, %ld effects run on overflow\n", eventQueue.numCoalesced, eventQueue.numEventsOverflow, eventQueue.numEffectsOverflow);
+    printf("explosions: %ld merged, %ld dropped\n", explosionResolver.numMerged, explosionResolver.numDropped);
+    printf("wall time: %.3f s\n", elapsed);
+    printf("cpu time: %.3f s\n", cpuTime);
+    printf("frames/s: %.1f\n", elapsed > 0 ? frame/elapsed : 0.0);
+    if (traceFile != NULL && !ProfileExportTrace(traceFile))
+        fprintf(stderr, "headless: não foi possível criar o trace '%s'\n", traceFile);
+
+    UnloadWorld(&world);
+    ArenaDestroy(&world.arena);
+    JobSystemShutdown();
+    UnloadRenderTexturePool();
+    free(fxSoundPool);
+    return 0;
+}
+#endif
@@ -0,0 +1,115 @@
+// Tiros hitscan (SNIPER e LASER)
+// Não ocupam a bulletsPool: o tiro entra na fila de eventos e, no DispatchEvents do mesmo passo, vira um
+// raio contra grounds sólidos, props e inimigos (ou o player), com uma consulta na broadphase por pool.
+// Vale o primeiro objeto atingido, e fica só um feixe curto na beamsPool para o desenho (beamLifeTime).
+// Armas de cadência alta não enchem a bulletsPool e custam o mesmo que um tiro só.
+
+// Alcance e dano de cada tipo, indexados pelo enum BULLET_TYPE (MAGNUM é projétil, não usa)
+const static float hitscanRange[] = {0, 1920, 1200};
+const static int hitscanEnemyDamage[] = {0, 100, 25};
+const static int hitscanPlayerDamage[] = {0, 40, 10};
+const static float beamFrameTime = 0.04f; // s por quadro de MISC_LASER_BEAM_ROW
+
+typedef struct hitscanShot {
+    Vector2 origin;
+    Vector2 direction; // Normalizada
+    enum BULLET_TYPE bulletType;
+    enum ENTITY_TYPES srcEntity;
+} HitscanShot;
+
+// Mesma origem e direção de uma bala do CreateBullet
+HitscanShot HitscanFromEntity(Entity *entity, enum BULLET_TYPE bulletType, enum ENTITY_TYPES srcEntity) {
+    HitscanShot shot;
+    float dirX = entity->lowerAnimation.isFacingRight;
+    float dirY = (entity->upPressed ? -1 : entity->downPressed ? 1 : 0);
+    float len = sqrtf(dirX*dirX + dirY*dirY);
+    shot.origin = (Vector2) {entity->position.x, entity->position.y + entity->eyesOffset.y};
+    shot.direction = (Vector2) {dirX/len, dirY/len};
+    shot.bulletType = bulletType;
+    shot.srcEntity = srcEntity;
+    return shot;
+}
+
+void CreateBeam(Beam *beamsPool, HitscanShot shot, Vector2 end) {
+    int i = PoolAlloc(beamsPool);
+    if (i == -1) return; // Pool cheia: o tiro já foi resolvido, só não aparece
+    Beam *beam = beamsPool + i;
+    beam->start = shot.origin;
+    beam->end = end;
+    beam->angle = atan2f(end.y - shot.origin.y, end.x - shot.origin.x)*RAD2DEG;
+    beam->bulletType = shot.bulletType;
+    beam->lifeTime = 0;
+    beam->currentFrame = 0;
+    beam->isActive = true;
+}
+
+// Resolve o tiro: o raio vai até o primeiro objeto atingido (ou até o alcance) e aplica o efeito dele
+void FireHitscan(World *world, HitscanShot shot) {
+    float range = hitscanRange[shot.bulletType];
+    Vector2 motion = {shot.direction.x*range, shot.direction.y*range};
+    float t, hitT = 1; // Fração do alcance
+    int hitProp = -1, hitEnemy = -1;
+    bool hitPlayer = false;
+    Vector2 normal;
+    Rectangle point = {shot.origin.x, shot.origin.y, 0, 0}; // O raio é uma caixa de tamanho zero contra corpo e cabeça
+    int candidates[spatialMaxResults];
+
+    // Grounds sólidos só param o raio. Começando dentro de um (t = 0) o raio segue
+    int numCandidates = SpatialHashQueryRay(PoolGrid(world->groundPool), shot.origin, shot.direction, range, candidates, spatialMaxResults);
+    for (int n = 0; n < numCandidates; n++) {
+        Ground *curGround = world->groundPool + candidates[n];
+        if (curGround->isActive && curGround->objType == -1 && SweepSegmentRect(shot.origin, motion, curGround->rect, &t, &normal) && t > 0 && t < hitT)
+            hitT = t;
+    }
+
+    // Props
+    numCandidates = SpatialHashQueryRay(PoolGrid(world->envPropsPool), shot.origin, shot.direction, range, candidates, spatialMaxResults);
+    for (int n = 0; n < numCandidates; n++) {
+        EnvProps *curProp = world->envPropsPool + candidates[n];
+        if (curProp->isActive && SweepSegmentRect(shot.origin, motion, curProp->collisionRect, &t, &normal) && t < hitT) {
+            hitT = t;
+            hitProp = candidates[n];
+        }
+    }
+
+    // Inimigos (caixa ou cabeça)
+    if (shot.srcEntity == PLAYER) {
+        numCandidates = SpatialHashQueryRay(PoolGrid(world->enemyPool), shot.origin, shot.direction, range, candidates, spatialMaxResults);
+        EnemyCollider *colliders = (EnemyCollider *)PoolHotData(world->enemyPool);
+        for (int n = 0; n < numCandidates; n++) {
+            EnemyCollider *collider = colliders + candidates[n];
+            if (collider->isHittable && SweepRectBody(point, motion, collider->collisionBox, collider->collisionHead, &t) && t < hitT) {
+                hitT = t;
+                hitProp = -1;
+                hitEnemy = candidates[n];
+            }
+        }
+    }
+
+    // Player
+    Entity *pEnt = &world->player.entity;
+    if (shot.srcEntity == ENEMY) {
+        if (SweepRectBody(point, motion, pEnt->collisionBox, pEnt->collisionHead, &t) && t < hitT) {
+            hitT = t;
+            hitProp = -1;
+            hitPlayer = true;
+        }
+    }
+
+    int facing = (shot.direction.x < 0 ? -1 : 1);
+    if (hitProp != -1) {
+        EnvProps *curProp = world->envPropsPool + hitProp;
+        if (curProp->isDestroyable && RngValue(RNG_EFFECTS, 1,3) == 1) // Mesma chance de uma bala
+            DestroyEnvProp(&world->player, world->enemyPool, world->envPropsPool, world->groundPool, world->particlePool, world->fxSoundPool, world->msgPool, curProp->id, world->difficulty);
+    } else if (hitEnemy != -1) {
+        Enemy *curEnemy = world->enemyPool + hitEnemy;
+        CreateParticle(curEnemy->entity.position, (Vector2) {0,0}, world->particlePool, BLOOD_SPILL, 2.5f, 0, (Vector2){1,1}, false, facing);
+        curEnemy->entity.lowerAnimation.isFacingRight = -facing;
+        HurtEntity(&(curEnemy->entity), world->fxSoundPool, hitscanEnemyDamage[shot.bulletType]); // Se zerar a vida, o DispatchEvents mata o inimigo
+    } else if (hitPlayer) {
+        HurtEntity(pEnt, world->fxSoundPool, hitscanPlayerDamage[shot.bulletType]);
+        CreateParticle(pEnt->position, (Vector2) {0,0}, world->particlePool, BLOOD_SPILL, 2.5f, 0, (Vector2){1,1}, false, facing);
+    }
+
+    CreateBeam(world->beamsPool, shot, (Vector2) {shot.origin.x + motion.x*hitT, shot.origin.y + motion.y*hitT});
+}
@@ -0,0 +1,153 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+// Sistema de jobs (laços paralelos da simulação)
+// Um grupo fixo de threads criado no início do programa. JobParallelFor divide o intervalo [0, count) em
+// pedaços de batchSize e cada thread livre, inclusive a principal, pega o próximo pedaço ainda não feito
+// (um contador atômico), então uma thread que termina cedo continua puxando trabalho das outras.
+// A chamada só volta quando todos os pedaços terminaram. O kernel recebe o índice do pedaço: quem precisa
+// juntar resultados na ordem do laço serial (ex: comandos adiados) usa um buffer por pedaço.
+#define jobMaxThreads 8 // Contando a thread principal
+
+typedef void (*JobKernel)(void *context, int begin, int end, int chunk);
+
+typedef struct jobSystem {
+    pthread_t workers[jobMaxThreads];
+    int numThreads; // 1: tudo roda na thread principal
+    pthread_mutex_t mutex;
+    pthread_cond_t wake; // Trabalho novo ou fim
+    pthread_cond_t done; // Pedaços terminados
+    // Trabalho atual (escrito pela thread principal com o mutex, antes de acordar as outras)
+    JobKernel kernel;
+    void *context;
+    int count;
+    int batchSize;
+    int numChunks;
+    atomic_int nextChunk;
+    int numChunksDone;
+    int numBusy; // Threads de trabalho ainda dentro do trabalho atual
+    int generation;
+    bool quit;
+} JobSystem;
+
+static JobSystem jobSystem;
+static _Thread_local int jobThreadIndex = 0; // 0 na thread principal
+
+int NumCpuCores(void) {
+#if defined(_SC_NPROCESSORS_ONLN)
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores > 0) return (int)cores;
+#endif
+    return 4;
+}
+
+// Pega pedaços até acabar. Retorna quantos foram feitos por esta thread
+int JobRunChunks(JobKernel kernel, void *context, int count, int batchSize, int numChunks) {
+    int numDone = 0;
+    int chunk;
+    while ((chunk = atomic_fetch_add(&jobSystem.nextChunk, 1)) < numChunks) {
+        int begin = chunk*batchSize;
+        int end = begin + batchSize < count ? begin + batchSize : count;
+        kernel(context, begin, end, chunk);
+        numDone++;
+    }
+    return numDone;
+}
+
+void *JobWorker(void *arg) {
+    jobThreadIndex = (int)(intptr_t)arg;
+    int seenGeneration = 0;
+    pthread_mutex_lock(&jobSystem.mutex);
+    while (true) {
+        while (!jobSystem.quit && jobSystem.generation == seenGeneration)
+            pthread_cond_wait(&jobSystem.wake, &jobSystem.mutex);
+        if (jobSystem.quit) break;
+        seenGeneration = jobSystem.generation;
+        JobKernel kernel = jobSystem.kernel;
+        void *context = jobSystem.context;
+        int count = jobSystem.count, batchSize = jobSystem.batchSize, numChunks = jobSystem.numChunks;
+        jobSystem.numBusy++;
+        pthread_mutex_unlock(&jobSystem.mutex);
+
+        int numDone = JobRunChunks(kernel, context, count, batchSize, numChunks);
+
+        pthread_mutex_lock(&jobSystem.mutex);
+        jobSystem.numChunksDone += numDone;
+        jobSystem.numBusy--;
+        if (jobSystem.numBusy == 0) pthread_cond_signal(&jobSystem.done);
+    }
+    pthread_mutex_unlock(&jobSystem.mutex);
+    return NULL;
+}
+
+// numThreads <= 0: uma thread por núcleo
+void JobSystemInit(int numThreads) {
+    if (numThreads <= 0) numThreads = NumCpuCores();
+    if (numThreads > jobMaxThreads) numThreads = jobMaxThreads;
+    jobSystem.numThreads = numThreads;
+    jobSystem.generation = 0;
+    jobSystem.quit = false;
+    pthread_mutex_init(&jobSystem.mutex, NULL);
+    pthread_cond_init(&jobSystem.wake, NULL);
+    pthread_cond_init(&jobSystem.done, NULL);
+    for (int t = 1; t < numThreads; t++)
+        pthread_create(&jobSystem.workers[t], NULL, JobWorker, (void *)(intptr_t)t);
+}
+
+void JobSystemShutdown(void) {
+    if (jobSystem.numThreads == 0) return;
+    pthread_mutex_lock(&jobSystem.mutex);
+    jobSystem.quit = true;
+    pthread_cond_broadcast(&jobSystem.wake);
+    pthread_mutex_unlock(&jobSystem.mutex);
+    for (int t = 1; t < jobSystem.numThreads; t++)
+        pthread_join(jobSystem.workers[t], NULL);
+    pthread_mutex_destroy(&jobSystem.mutex);
+    pthread_cond_destroy(&jobSystem.wake);
+    pthread_cond_destroy(&jobSystem.done);
+    jobSystem.numThreads = 0;
+}
+
+// Número de pedaços em que JobParallelFor vai dividir o intervalo
+int JobNumChunks(int count, int batchSize) {
+    return (count + batchSize - 1)/batchSize;
+}
+
+// Roda kernel(context, begin, end, chunk) sobre [0, count) em pedaços de batchSize, em paralelo.
+// Com uma thread só, ou um pedaço só, roda direto na thread principal
+void JobParallelFor(JobKernel kernel, void *context, int count, int batchSize) {
+    int numChunks = JobNumChunks(count, batchSize);
+    if (numChunks == 0) return;
+    if (jobSystem.numThreads <= 1 || numChunks == 1) {
+        for (int chunk = 0; chunk < numChunks; chunk++) {
+            int begin = chunk*batchSize;
+            kernel(context, begin, begin + batchSize < count ? begin + batchSize : count, chunk);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&jobSystem.mutex);
+    while (jobSystem.numBusy > 0) // Thread que acordou tarde para o trabalho anterior ainda está no contador dele
+        pthread_cond_wait(&jobSystem.done, &jobSystem.mutex);
+    jobSystem.kernel = kernel;
+    jobSystem.context = context;
+    jobSystem.count = count;
+    jobSystem.batchSize = batchSize;
+    jobSystem.numChunks = numChunks;
+    jobSystem.numChunksDone = 0;
+    atomic_store(&jobSystem.nextChunk, 0);
+    jobSystem.generation++;
+    pthread_cond_broadcast(&jobSystem.wake);
+    pthread_mutex_unlock(&jobSystem.mutex);
+
+    int numDone = JobRunChunks(kernel, context, count, batchSize, numChunks);
+
+    // Espera também as threads que acordaram tarde saírem, antes que o próximo trabalho reinicie o contador
+    pthread_mutex_lock(&jobSystem.mutex);
+    jobSystem.numChunksDone += numDone;
+    while (jobSystem.numChunksDone < numChunks || jobSystem.numBusy > 0)
+        pthread_cond_wait(&jobSystem.done, &jobSystem.mutex);
+    pthread_mutex_unlock(&jobSystem.mutex);
+}
@@ -0,0 +1,121 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Pool genérica de objetos
+// O cabeçalho fica guardado logo antes do array de objetos, então a pool continua sendo
+// um ponteiro comum (Bullet *, Particle *, ...) e pode ser indexada e passada para as funções como antes.
+// - freeList: pilha de índices livres -> alocação O(1)
+// - activeList: lista densa dos índices em uso -> iteração proporcional aos objetos vivos
+// A flag de cada objeto (isActive/isAlive) continua sendo quem diz se ele está vivo:
+// quem desativa um objeto só zera a flag e PoolSweep devolve o índice para a freeList no fim do frame.
+typedef struct poolHeader {
+    int capacity;
+    int elemSize;
+    int flagOffset; // offsetof da flag bool que indica se o objeto está vivo
+    int numFree;
+    int numActive;
+    int numAllocs; // Total de alocações, indica quando a pool mudou
+    int *freeList;
+    int *activeList;
+    struct spatialHash *grid; // Broadphase associada à pool (NULL se não tiver)
+    void *hotData; // Array paralelo com a parte quente dos objetos, mesmo índice (NULL se não tiver)
+} PoolHeader;
+
+// Tamanho do cabeçalho arredondado para manter o alinhamento dos objetos
+#define poolHeaderSize ((sizeof(PoolHeader) + 15) & ~(size_t)15)
+
+PoolHeader *PoolGetHeader(void *pool) {
+    return (PoolHeader *)((char *)pool - poolHeaderSize);
+}
+
+bool *PoolFlag(PoolHeader *header, void *pool, int i) {
+    return (bool *)((char *)pool + (size_t)i*header->elemSize + header->flagOffset);
+}
+
+// Aloca a pool na arena, com todos os objetos zerados e inativos. Ela vive até o ArenaReset
+void *PoolCreate(Arena *arena, int capacity, int elemSize, int flagOffset) {
+    size_t dataSize = (size_t)capacity*elemSize;
+    char *block = (char *)ArenaAlloc(arena, poolHeaderSize + dataSize + 2*capacity*sizeof(int)); // Objetos zerados
+    if (block == NULL) return NULL;
+
+    PoolHeader *header = (PoolHeader *)block;
+    void *pool = block + poolHeaderSize;
+    header->capacity = capacity;
+    header->elemSize = elemSize;
+    header->flagOffset = flagOffset;
+    header->freeList = (int *)((char *)pool + dataSize);
+    header->activeList = header->freeList + capacity;
+    header->numActive = 0;
+    header->numFree = capacity;
+
+    // Empilhado ao contrário para que os primeiros índices sejam usados primeiro
+    for (int i = 0; i < capacity; i++) {
+        header->freeList[i] = capacity - 1 - i;
+        *PoolFlag(header, pool, i) = false;
+    }
+
+    return pool;
+}
+
+// Retorna o índice de um slot livre (já inserido na lista de ativos) ou -1 se a pool estiver cheia
+int PoolAlloc(void *pool) {
+    PoolHeader *header = PoolGetHeader(pool);
+    if (header->numFree == 0) return -1;
+
+    int i = header->freeList[--header->numFree];
+    header->activeList[header->numActive++] = i;
+    header->numAllocs++;
+    return i;
+}
+
+// Remove da lista de ativos os objetos que foram desativados, mantendo a ordem dos restantes
+void PoolSweep(void *pool) {
+    PoolHeader *header = PoolGetHeader(pool);
+    int numAlive = 0;
+
+    for (int n = 0; n < header->numActive; n++) {
+        int i = header->activeList[n];
+        if (*PoolFlag(header, pool, i))
+            header->activeList[numAlive++] = i;
+        else
+            header->freeList[header->numFree++] = i;
+    }
+    header->numActive = numAlive;
+}
+
+// Lista densa dos índices em uso. Pode conter objetos desativados neste frame (checar a flag)
+int *PoolActive(void *pool) {
+    return PoolGetHeader(pool)->activeList;
+}
+
+int PoolCount(void *pool) {
+    return PoolGetHeader(pool)->numActive;
+}
+
+int PoolAllocCount(void *pool) {
+    return PoolGetHeader(pool)->numAllocs;
+}
+
+// Associa um spatial hash à pool, para que as funções de colisão o encontrem a partir do ponteiro da pool
+void PoolSetGrid(void *pool, struct spatialHash *grid) {
+    PoolGetHeader(pool)->grid = grid;
+}
+
+struct spatialHash *PoolGrid(void *pool) {
+    return PoolGetHeader(pool)->grid;
+}
+
+// Percorre os índices em uso da pool: POOL_FOREACH(i, bulletsPool) { Bullet *b = bulletsPool + i; ... }
+// Objetos criados durante o laço também são visitados
+#define POOL_FOREACH(i, pool) for (int i##_n = 0, i = 0; i##_n < PoolCount(pool) && ((i = PoolActive(pool)[i##_n]), 1); i##_n++)
+
+// Associa à pool um array paralelo com os campos mais lidos dos objetos (ex: colisão), para que os laços
+// quentes leiam um array pequeno e contínuo em vez das structs inteiras
+void PoolSetHotData(void *pool, void *hotData) {
+    PoolGetHeader(pool)->hotData = hotData;
+}
+
+void *PoolHotData(void *pool) {
+    return PoolGetHeader(pool)->hotData;
+}
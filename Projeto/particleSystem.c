@@ -0,0 +1,195 @@
+#include <stdlib.h>
+#include <stdbool.h>
+
+// Partículas em structure-of-arrays
+// Cada campo fica num array próprio e as partículas vivas ocupam sempre [0, count): quem morre no passo é
+// trocado pela última (compactação), então o update percorre só memória contínua e o desenho não precisa
+// testar flag. O update de todos os campos quentes (posição, ângulo, escala, animação) é um único kernel
+// vetorizado: AVX (8 partículas por vez) ou SSE2 (4), com fallback escalar nas outras plataformas.
+// Compilar com -mavx para usar o caminho de 8 lanes.
+// Com dezenas de milhares de partículas o kernel é limitado pela memória, então só fica no array o que
+// muda por partícula: a posição anterior (interpolação do desenho) é recalculada a partir da velocidade e
+// a velocidade da animação é a mesma para todas.
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define particleLanes 8
+    typedef __m256 PVec;
+    #define PVecLoad(p) _mm256_loadu_ps(p)
+    #define PVecStore(p, v) _mm256_storeu_ps(p, v)
+    #define PVecSet(x) _mm256_set1_ps(x)
+    #define PVecAdd(a, b) _mm256_add_ps(a, b)
+    #define PVecMul(a, b) _mm256_mul_ps(a, b)
+    #define PVecGE(a, b) _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+    #define PVecGT(a, b) _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+    #define PVecLE(a, b) _mm256_cmp_ps(a, b, _CMP_LE_OQ)
+    #define PVecLT(a, b) _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+    #define PVecAnd(a, b) _mm256_and_ps(a, b)
+    #define PVecAndNot(a, b) _mm256_andnot_ps(b, a) // a & ~b
+    #define PVecOr(a, b) _mm256_or_ps(a, b)
+    #define PVecSelect(mask, a, b) _mm256_blendv_ps(b, a, mask)
+    #define PVecMaskBits(mask) _mm256_movemask_ps(mask)
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define particleLanes 4
+    typedef __m128 PVec;
+    #define PVecLoad(p) _mm_loadu_ps(p)
+    #define PVecStore(p, v) _mm_storeu_ps(p, v)
+    #define PVecSet(x) _mm_set1_ps(x)
+    #define PVecAdd(a, b) _mm_add_ps(a, b)
+    #define PVecMul(a, b) _mm_mul_ps(a, b)
+    #define PVecGE(a, b) _mm_cmpge_ps(a, b)
+    #define PVecGT(a, b) _mm_cmpgt_ps(a, b)
+    #define PVecLE(a, b) _mm_cmple_ps(a, b)
+    #define PVecLT(a, b) _mm_cmplt_ps(a, b)
+    #define PVecAnd(a, b) _mm_and_ps(a, b)
+    #define PVecAndNot(a, b) _mm_andnot_ps(b, a) // a & ~b
+    #define PVecOr(a, b) _mm_or_ps(a, b)
+    #define PVecSelect(mask, a, b) _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b))
+    #define PVecMaskBits(mask) _mm_movemask_ps(mask)
+#else
+    // Escalar: as máscaras são bool e o mesmo kernel roda uma partícula por vez
+    #define particleLanes 1
+    typedef float PVec;
+    #define PVecLoad(p) (*(p))
+    #define PVecStore(p, v) (*(p) = (v))
+    #define PVecSet(x) (x)
+    #define PVecAdd(a, b) ((a) + (b))
+    #define PVecMul(a, b) ((a) * (b))
+    #define PVecGE(a, b) ((a) >= (b))
+    #define PVecGT(a, b) ((a) > (b))
+    #define PVecLE(a, b) ((a) <= (b))
+    #define PVecLT(a, b) ((a) < (b))
+    #define PVecAnd(a, b) ((a) && (b))
+    #define PVecAndNot(a, b) ((a) && !(b))
+    #define PVecOr(a, b) ((a) || (b))
+    #define PVecSelect(mask, a, b) ((mask) ? (a) : (b))
+    #define PVecMaskBits(mask) ((int)(mask))
+#endif
+
+typedef struct particleSystem {
+    int count; // Vivas, sempre em [0, count)
+    int capacity; // Múltiplo de particleLanes, o kernel pode passar do count até o fim do último bloco
+    float width, height; // Tamanho do quadro no atlas (o mesmo para todas)
+    float stepTime; // delta do último update, posição anterior = posição - velocidade*stepTime
+    // Quentes: lidos e escritos pelo kernel
+    float *posX, *posY;
+    float *velX, *velY;
+    float *angle, *angularVelocity;
+    float *scale, *scaleMin, *scaleMax, *scaleDir; // scaleDir: +1 crescendo, -1 diminuindo
+    float *frameTime, *frame, *numFrames; // frame guardado em float para ficar no mesmo registrador
+    float *loop; // 1 se a animação repete, 0 se a partícula morre no último quadro
+    // Frios: só usados no desenho
+    int *frameRow;
+    int *facing; // 1 ou -1
+    unsigned char *dead; // Marcado pelo kernel, consumido pela compactação
+} ParticleSystem;
+
+#define particleNumFloatFields 14
+#define particleFrameSpeed 0.08f // s por quadro
+
+// Tudo sai da arena da partida (não tem destroy: a memória volta no ArenaReset)
+ParticleSystem *ParticleSystemCreate(Arena *arena, int capacity, float width, float height) {
+    capacity = (capacity + 7) & ~7; // Múltiplo de 8 serve para qualquer largura de vetor
+    ParticleSystem *ps = (ParticleSystem *)ArenaAlloc(arena, sizeof(ParticleSystem));
+    // Arrays separados por uma linha de cache a mais que o necessário: com a distância exata (potência de 2)
+    // todos caem no mesmo conjunto da cache L1 e o kernel perde a maior parte do tempo em conflito
+    size_t stride = (size_t)capacity + 16;
+    float *floats = (float *)ArenaAlloc(arena, stride*particleNumFloatFields*sizeof(float));
+    float **fields[particleNumFloatFields] = {&ps->posX, &ps->posY, &ps->velX, &ps->velY, &ps->angle, &ps->angularVelocity,
+        &ps->scale, &ps->scaleMin, &ps->scaleMax, &ps->scaleDir, &ps->frameTime, &ps->frame, &ps->numFrames, &ps->loop};
+    for (int f = 0; f < particleNumFloatFields; f++)
+        *fields[f] = floats + f*stride;
+    ps->frameRow = (int *)ArenaAlloc(arena, capacity*sizeof(int));
+    ps->facing = (int *)ArenaAlloc(arena, capacity*sizeof(int));
+    ps->dead = (unsigned char *)ArenaAlloc(arena, capacity);
+    ps->capacity = capacity;
+    ps->width = width;
+    ps->height = height;
+    return ps;
+}
+
+// Índice da nova partícula, ou -1 se estiver cheio. Os campos são preenchidos por quem chamou
+int ParticleSystemAdd(ParticleSystem *ps) {
+    if (ps->count == ps->capacity) return -1;
+    return ps->count++;
+}
+
+// Copia a partícula src para dst (usado na compactação)
+void ParticleSystemMove(ParticleSystem *ps, int dst, int src) {
+    float *fields[particleNumFloatFields] = {ps->posX, ps->posY, ps->velX, ps->velY, ps->angle, ps->angularVelocity,
+        ps->scale, ps->scaleMin, ps->scaleMax, ps->scaleDir, ps->frameTime, ps->frame, ps->numFrames, ps->loop};
+    for (int f = 0; f < particleNumFloatFields; f++)
+        fields[f][dst] = fields[f][src];
+    ps->frameRow[dst] = ps->frameRow[src];
+    ps->facing[dst] = ps->facing[src];
+}
+
+#define particleJobBatchSize 4096 // Partículas por pedaço no update paralelo (múltiplo de particleLanes)
+
+typedef struct particleStep {
+    ParticleSystem *ps;
+    float delta, minX;
+} ParticleStep;
+
+// Kernel do update: partículas [begin, end). Cada pedaço só escreve nos seus índices
+void ParticleSystemStepChunk(void *context, int begin, int end, int chunk) {
+    ParticleStep *step = (ParticleStep *)context;
+    ParticleSystem *ps = step->ps;
+    const PVec vDelta = PVecSet(step->delta), vMinX = PVecSet(step->minX), vWidth = PVecSet(ps->width);
+    const PVec vZero = PVecSet(0.0f), vOne = PVecSet(1.0f), vMinusOne = PVecSet(-1.0f), vFrameSpeed = PVecSet(particleFrameSpeed);
+    for (int i = begin; i < end; i += particleLanes) {
+        PVec posX = PVecLoad(ps->posX + i), posY = PVecLoad(ps->posY + i), scale = PVecLoad(ps->scale + i);
+
+        // Saiu da tela (com o retângulo do passo anterior, como o resto do mundo)
+        PVec offscreen = PVecLT(PVecAdd(posX, PVecMul(vWidth, scale)), vMinX);
+
+        // Movimento
+        PVecStore(ps->posX + i, PVecAdd(posX, PVecMul(PVecLoad(ps->velX + i), vDelta)));
+        PVecStore(ps->posY + i, PVecAdd(posY, PVecMul(PVecLoad(ps->velY + i), vDelta)));
+        PVecStore(ps->angle + i, PVecAdd(PVecLoad(ps->angle + i), PVecMul(PVecLoad(ps->angularVelocity + i), vDelta)));
+
+        // Escala oscilando entre scaleMin e scaleMax, 1 unidade por passo
+        PVec scaleDir = PVecLoad(ps->scaleDir + i), scaleMin = PVecLoad(ps->scaleMin + i), scaleMax = PVecLoad(ps->scaleMax + i);
+        PVec growing = PVecGT(scaleDir, vZero);
+        scale = PVecAdd(scale, scaleDir);
+        PVec hitMax = PVecAnd(growing, PVecGE(scale, scaleMax));
+        PVec hitMin = PVecAndNot(PVecLE(scale, scaleMin), growing);
+        scale = PVecSelect(hitMax, scaleMax, PVecSelect(hitMin, scaleMin, scale));
+        PVecStore(ps->scale + i, scale);
+        PVecStore(ps->scaleDir + i, PVecSelect(PVecOr(hitMax, hitMin), PVecMul(scaleDir, vMinusOne), scaleDir));
+
+        // Animação
+        PVec frameTime = PVecAdd(PVecLoad(ps->frameTime + i), vDelta);
+        PVec nextFrame = PVecGE(frameTime, vFrameSpeed);
+        PVec frame = PVecLoad(ps->frame + i);
+        frame = PVecSelect(nextFrame, PVecAdd(frame, vOne), frame);
+        PVec ended = PVecGT(frame, PVecAdd(PVecLoad(ps->numFrames + i), vMinusOne));
+        PVec loops = PVecGT(PVecLoad(ps->loop + i), vZero);
+        PVecStore(ps->frameTime + i, PVecSelect(nextFrame, vZero, frameTime));
+        PVecStore(ps->frame + i, PVecSelect(PVecAnd(ended, loops), vZero, frame));
+
+        int deadBits = PVecMaskBits(PVecOr(offscreen, PVecAndNot(ended, loops)));
+        for (int lane = 0; lane < particleLanes; lane++)
+            ps->dead[i + lane] = (deadBits >> lane) & 1;
+    }
+}
+
+// Avança todas as partículas um passo e remove as que morreram (saíram da tela pela esquerda ou
+// terminaram uma animação sem repetição). O kernel roda em paralelo no sistema de jobs, a compactação em série
+void ParticleSystemUpdate(ParticleSystem *ps, float delta, float minX) {
+    ps->stepTime = delta;
+    ParticleStep step = {ps, delta, minX};
+    JobParallelFor(ParticleSystemStepChunk, &step, ps->count, particleJobBatchSize);
+
+    // Compactação: a última viva ocupa o lugar de cada morta
+    int i = 0;
+    while (i < ps->count) {
+        if (ps->dead[i]) {
+            ps->count--;
+            ps->dead[i] = ps->dead[ps->count];
+            ParticleSystemMove(ps, i, ps->count);
+        } else {
+            i++;
+        }
+    }
+}
@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Profiler por subsistema
+// Cada bloco do update, cada passada de desenho e algumas funções pesadas marcam o começo e o fim da sua
+// zona. O tempo de cada zona fica somado no frame atual (um frame pode ter vários passos de simulação) e cada
+// marcação vira um evento com início e duração. No fim do frame o total vai para um ring buffer com os
+// últimos profileNumFrames frames, usado pelo overlay (F3) e pela exportação no formato de trace do Chrome
+// (chrome://tracing ou ui.perfetto.dev).
+// Com o profiler desligado cada marcação é só um teste de flag.
+#define profileNumFrames 240
+#define profileMaxEvents 65536 // Ring buffer de eventos, compartilhado por todos os frames guardados
+#define profileBudgetMs (1000.0f/60.0f)
+#define profileBarWidth 2 // px por frame no gráfico do overlay
+
+enum PROFILE_ZONE {
+    PROF_PLAYER, PROF_ENEMIES, PROF_BULLETS, PROF_GRENADES, PROF_GROUNDS, PROF_PROPS, PROF_EVENTS, PROF_PARTICLES, PROF_MSGS, PROF_BACKGROUNDS,
+    PROF_DRAW_BACKGROUNDS, PROF_DRAW_WORLD, PROF_DRAW_HUD,
+    // Zonas aninhadas: o tempo delas já está dentro das zonas acima, ficam fora do gráfico empilhado
+    PROF_PAINT_CANVAS, PROF_PLAN_CHUNK, PROF_COLLISION,
+    NUM_PROFILE_ZONES
+};
+#define profileFirstNestedZone PROF_PAINT_CANVAS
+
+static const char *profileZoneNames[NUM_PROFILE_ZONES] = {"player", "enemies", "bullets", "grenades", "grounds", "props", "events", "particles", "msgs", "backgrounds",
+    "draw_backgrounds", "draw_world", "draw_hud", "paint_canvas", "plan_chunk", "collision"};
+
+typedef struct profileEvent {
+    double start; // s
+    float duration; // s
+    int zone;
+} ProfileEvent;
+
+typedef struct profileFrameRecord {
+    double start; // s
+    float total; // s, do ProfileBeginFrame ao ProfileEndFrame
+    float zones[NUM_PROFILE_ZONES]; // s
+    long firstEvent; // Índice absoluto do primeiro evento (ring buffer de eventos)
+    int numEvents;
+} ProfileFrameRecord;
+
+static bool profilerEnabled = false;
+static double profileFrame[NUM_PROFILE_ZONES]; // s, somado desde o último ProfileBeginFrame
+static double profileZoneStart[NUM_PROFILE_ZONES];
+static double profileFrameStart;
+static long profileFirstEventOfFrame;
+
+static ProfileFrameRecord profileFrames[profileNumFrames];
+static long profileNumRecorded; // Total de frames gravados (o ring guarda os últimos profileNumFrames)
+static ProfileEvent profileEvents[profileMaxEvents];
+static long profileNumEvents; // Total de eventos gravados
+
+// Só a thread principal é medida (zonas chamadas dentro de jobs medem a parte que ela fez)
+void ProfileBegin(enum PROFILE_ZONE zone) {
+    if (profilerEnabled && jobThreadIndex == 0) profileZoneStart[zone] = GetTime();
+}
+
+void ProfileEnd(enum PROFILE_ZONE zone) {
+    if (!profilerEnabled || jobThreadIndex != 0) return;
+    double end = GetTime();
+    profileFrame[zone] += end - profileZoneStart[zone];
+
+    ProfileEvent *event = &profileEvents[profileNumEvents%profileMaxEvents];
+    event->start = profileZoneStart[zone];
+    event->duration = end - profileZoneStart[zone];
+    event->zone = zone;
+    profileNumEvents++;
+}
+
+void ProfileBeginFrame(void) {
+    memset(profileFrame, 0, sizeof(profileFrame));
+    if (!profilerEnabled) return;
+    profileFrameStart = GetTime();
+    profileFirstEventOfFrame = profileNumEvents;
+}
+
+void ProfileEndFrame(void) {
+    if (!profilerEnabled) return;
+    ProfileFrameRecord *record = &profileFrames[profileNumRecorded%profileNumFrames];
+    record->start = profileFrameStart;
+    record->total = GetTime() - profileFrameStart;
+    for (int z = 0; z < NUM_PROFILE_ZONES; z++)
+        record->zones[z] = profileFrame[z];
+    record->firstEvent = profileFirstEventOfFrame;
+    record->numEvents = profileNumEvents - profileFirstEventOfFrame;
+    profileNumRecorded++;
+}
+
+// Liga/desliga a coleta. Ao ligar, descarta o que foi gravado antes
+void ProfileSetEnabled(bool enabled) {
+    if (enabled && !profilerEnabled) {
+        profileNumRecorded = 0;
+        profileNumEvents = 0;
+    }
+    profilerEnabled = enabled;
+}
+
+// i = 0 é o frame mais recente
+ProfileFrameRecord *ProfileGetFrame(int i) {
+    if (i >= profileNumRecorded || i >= profileNumFrames) return NULL;
+    return &profileFrames[(profileNumRecorded - 1 - i)%profileNumFrames];
+}
+
+//------------------------------------------------------------------------------------
+// Exportação (Chrome trace event format)
+//------------------------------------------------------------------------------------
+// Grava os frames guardados no ring buffer. Os eventos que já foram sobrescritos ficam de fora
+bool ProfileExportTrace(const char *fileName) {
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+
+    int numFrames = (profileNumRecorded < profileNumFrames ? profileNumRecorded : profileNumFrames);
+    long oldestEvent = (profileNumEvents > profileMaxEvents ? profileNumEvents - profileMaxEvents : 0);
+    bool first = true;
+    fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    for (int i = numFrames - 1; i >= 0; i--) {
+        ProfileFrameRecord *record = ProfileGetFrame(i);
+        fprintf(file, "%s{\"name\": \"frame\", \"cat\": \"frame\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": 1}",
+                first ? "" : ",\n", record->start*1e6, record->total*1e6);
+        first = false;
+        for (long e = record->firstEvent; e < record->firstEvent + record->numEvents; e++) {
+            if (e < oldestEvent) continue;
+            ProfileEvent *event = &profileEvents[e%profileMaxEvents];
+            fprintf(file, ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": 1}",
+                    profileZoneNames[event->zone], event->zone >= profileFirstNestedZone ? "detail" : "system", event->start*1e6, event->duration*1e6);
+        }
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+// Overlay
+//------------------------------------------------------------------------------------
+static const Color profileZoneColors[NUM_PROFILE_ZONES] = {
+    {0, 228, 48, 255}, {230, 41, 55, 255}, {253, 249, 0, 255}, {255, 161, 0, 255}, {130, 130, 130, 255}, {127, 106, 79, 255}, {0, 117, 44, 255},
+    {255, 109, 194, 255}, {102, 191, 255, 255}, {0, 82, 172, 255}, {135, 60, 190, 255}, {200, 122, 255, 255}, {211, 176, 131, 255},
+    {245, 245, 245, 255}, {245, 245, 245, 255}, {245, 245, 245, 255}
+};
+
+// Gráfico empilhado dos últimos frames (1 barra por frame, mais recente à direita) e ms médio de cada zona
+void DrawProfilerOverlay(int posX, int posY) {
+    const int barWidth = profileBarWidth, graphHeight = 160;
+    const float msToPx = graphHeight/(2*profileBudgetMs); // Escala: o topo do gráfico é 2x o orçamento do frame
+    int numFrames = (profileNumRecorded < profileNumFrames ? profileNumRecorded : profileNumFrames);
+    int graphWidth = profileNumFrames*barWidth;
+
+    DrawRectangle(posX - 10, posY - 10, graphWidth + 20, graphHeight + 30 + 22*(NUM_PROFILE_ZONES + 1), ColorAlpha(BLACK, 0.7f));
+
+    float average[NUM_PROFILE_ZONES] = {0}, averageTotal = 0;
+    for (int i = 0; i < numFrames; i++) {
+        ProfileFrameRecord *record = ProfileGetFrame(i);
+        int x = posX + graphWidth - (i + 1)*barWidth;
+        float y = posY + graphHeight;
+        for (int z = 0; z < profileFirstNestedZone; z++) {
+            float h = record->zones[z]*1000*msToPx;
+            if (y - h < posY) h = y - posY;
+            DrawRectangle(x, (int)(y - h), barWidth, (int)ceilf(h), profileZoneColors[z]);
+            y -= h;
+        }
+        for (int z = 0; z < NUM_PROFILE_ZONES; z++) average[z] += record->zones[z]*1000/numFrames;
+        averageTotal += record->total*1000/numFrames;
+    }
+
+    // Linha do orçamento de 16.6 ms
+    DrawRectangle(posX, posY + graphHeight - (int)(profileBudgetMs*msToPx), graphWidth, 1, RED);
+
+    int textY = posY + graphHeight + 10;
+    DrawText(TextFormat("frame  %.2f ms", averageTotal), posX, textY, 20, WHITE);
+    for (int z = 0; z < NUM_PROFILE_ZONES; z++) {
+        textY += 22;
+        DrawRectangle(posX, textY + 4, 12, 12, profileZoneColors[z]);
+        DrawText(TextFormat("%s  %.3f ms", profileZoneNames[z], average[z]), posX + 20, textY, 20, z >= profileFirstNestedZone ? GRAY : WHITE);
+    }
+}
@@ -0,0 +1,52 @@
+#include <stdbool.h>
+
+// Pool de RenderTextures (canvas dos backgrounds)
+// Cada chunk que sai da tela devolve o seu canvas e o chunk novo pega um livre do mesmo tamanho, então os
+// framebuffers só são criados na primeira vez e ficam vivos entre as partidas até UnloadRenderTexturePool.
+// Quem pega um canvas da pool recebe o conteúdo antigo e deve limpá-lo.
+#define renderTexturePoolCapacity 32 // 3 camadas x numBackgroundRendered, com folga
+
+typedef struct renderTexturePool {
+    RenderTexture2D textures[renderTexturePoolCapacity];
+    bool inUse[renderTexturePoolCapacity];
+    int count;
+    int numLoads; // Quantas vezes LoadRenderTexture foi chamado (só cresce se faltar textura do tamanho pedido)
+} RenderTexturePool;
+
+static RenderTexturePool renderTexturePool;
+
+RenderTexture2D AcquireRenderTexture(int width, int height) {
+    for (int i = 0; i < renderTexturePool.count; i++) {
+        RenderTexture2D *target = &renderTexturePool.textures[i];
+        if (!renderTexturePool.inUse[i] && target->texture.width == width && target->texture.height == height) {
+            renderTexturePool.inUse[i] = true;
+            return *target;
+        }
+    }
+
+    RenderTexture2D target = LoadRenderTexture(width, height);
+    renderTexturePool.numLoads++;
+    if (renderTexturePool.count < renderTexturePoolCapacity) { // Pool cheia: a textura fica fora e é descarregada ao ser devolvida
+        renderTexturePool.textures[renderTexturePool.count] = target;
+        renderTexturePool.inUse[renderTexturePool.count] = true;
+        renderTexturePool.count++;
+    }
+    return target;
+}
+
+void ReleaseRenderTexture(RenderTexture2D target) {
+    for (int i = 0; i < renderTexturePool.count; i++) {
+        if (renderTexturePool.textures[i].id == target.id) {
+            renderTexturePool.inUse[i] = false;
+            return;
+        }
+    }
+    UnloadRenderTexture(target);
+}
+
+// Chamado ao fechar o jogo, com todas as texturas já devolvidas
+void UnloadRenderTexturePool(void) {
+    for (int i = 0; i < renderTexturePool.count; i++)
+        UnloadRenderTexture(renderTexturePool.textures[i]);
+    renderTexturePool.count = 0;
+}
@@ -0,0 +1,202 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+// Entrada por tick e replays
+// A simulação não lê o teclado diretamente: a cada tick o player recebe um InputFrame, que pode vir
+// do teclado, do script do modo headless ou de um replay. O mesmo InputFrame é gravado no replay.
+//
+// Formato do arquivo (inteiros little-endian):
+//   "N30R" | versão (u8) | ticks por segundo (u8) | seed (u64) | número de ticks (u32, 0 se a gravação não foi fechada)
+//   sequência de blocos: repetições (varint) | down (u8) | pressed (u8)
+//   fim: repetições = 0
+// Cada bloco é uma entrada que se repete por N ticks, então só as mudanças de entrada ocupam espaço.
+#define replayVersion 10 // 2: chunks gerados com RNG por chunk (mundos diferentes da versão 1). 3: inimigos longe do player simulados com menos detalhe. 4: RNG da IA por inimigo. 5: dano, mortes e explosões resolvidos no fim do passo. 6: explosões em cadeia com limite por passo. 7: colisão contínua de balas e granadas. 8: inimigo sem vida não é atingido nem pontua de novo. 9: inimigo sem vida simulado por completo (morre no passo seguinte). 10: granada varre de novo o resto do passo depois de quicar
+#define replayHeaderSize 18
+#define replayBufferSize 4096
+
+enum INPUT_KEYS {INPUT_LEFT, INPUT_RIGHT, INPUT_UP, INPUT_DOWN, INPUT_JUMP, INPUT_SHOOT, INPUT_GRENADE, NUM_INPUT_KEYS};
+
+typedef struct inputFrame {
+    unsigned char down;    // Bits (1 << INPUT_KEYS) das teclas seguradas
+    unsigned char pressed; // Bits das teclas apertadas neste tick
+} InputFrame;
+
+// Teclas do jogo na mesma ordem de INPUT_KEYS
+static const int inputKeyMap[NUM_INPUT_KEYS] = {KEY_LEFT, KEY_RIGHT, KEY_UP, KEY_DOWN, KEY_SPACE, KEY_R, KEY_T};
+
+bool InputDown(InputFrame input, enum INPUT_KEYS key) {
+    return (input.down >> key) & 1;
+}
+
+bool InputPressed(InputFrame input, enum INPUT_KEYS key) {
+    return (input.pressed >> key) & 1;
+}
+
+InputFrame ReadKeyboardInput(void) {
+    InputFrame input = {0};
+    for (int i = 0; i < NUM_INPUT_KEYS; i++) {
+        if (IsKeyDown(inputKeyMap[i])) input.down |= 1 << i;
+        if (IsKeyPressed(inputKeyMap[i])) input.pressed |= 1 << i;
+    }
+    return input;
+}
+
+typedef struct replayWriter {
+    FILE *file;
+    unsigned char buffer[replayBufferSize];
+    int bufferUsed;
+    InputFrame last;
+    uint32_t runLength; // Ticks seguidos com a entrada "last" ainda não escritos
+    uint32_t numTicks;
+} ReplayWriter;
+
+typedef struct replayReader {
+    FILE *file;
+    unsigned char buffer[replayBufferSize];
+    int bufferUsed;
+    int bufferPos;
+    uint64_t seed;
+    uint32_t numTicks; // 0 se desconhecido
+    uint32_t tick;
+    InputFrame current;
+    uint32_t runLeft;
+    bool finished;
+} ReplayReader;
+
+void ReplayPutU32(unsigned char *dst, uint32_t v) {
+    for (int i = 0; i < 4; i++) dst[i] = (v >> (8*i)) & 0xFF;
+}
+
+uint32_t ReplayGetU32(const unsigned char *src) {
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+//------------------------------------------------------------------------------------
+// Gravação
+//------------------------------------------------------------------------------------
+ReplayWriter *ReplayOpenWriter(const char *fileName, uint64_t seed, int ticksPerSecond) {
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return NULL;
+
+    ReplayWriter *writer = (ReplayWriter *)calloc(1, sizeof(ReplayWriter));
+    writer->file = file;
+
+    unsigned char header[replayHeaderSize] = {'N', '3', '0', 'R', replayVersion, (unsigned char)ticksPerSecond};
+    ReplayPutU32(header + 6, (uint32_t)seed);
+    ReplayPutU32(header + 10, (uint32_t)(seed >> 32));
+    ReplayPutU32(header + 14, 0);
+    fwrite(header, 1, replayHeaderSize, file);
+    return writer;
+}
+
+void ReplayFlushBuffer(ReplayWriter *writer) {
+    fwrite(writer->buffer, 1, writer->bufferUsed, writer->file);
+    writer->bufferUsed = 0;
+}
+
+// Escreve o bloco pendente (repetições + entrada)
+void ReplayWriteRun(ReplayWriter *writer) {
+    if (writer->bufferUsed > replayBufferSize - 8) ReplayFlushBuffer(writer);
+
+    uint32_t v = writer->runLength;
+    do {
+        unsigned char byte = v & 0x7F;
+        v >>= 7;
+        writer->buffer[writer->bufferUsed++] = byte | (v ? 0x80 : 0);
+    } while (v);
+    writer->buffer[writer->bufferUsed++] = writer->last.down;
+    writer->buffer[writer->bufferUsed++] = writer->last.pressed;
+    writer->runLength = 0;
+}
+
+// Chamado uma vez por tick. Não aloca; só escreve no disco quando o buffer enche
+void ReplayRecordTick(ReplayWriter *writer, InputFrame input) {
+    if (writer->runLength > 0 && (input.down != writer->last.down || input.pressed != writer->last.pressed))
+        ReplayWriteRun(writer);
+    writer->last = input;
+    writer->runLength++;
+    writer->numTicks++;
+}
+
+void ReplayCloseWriter(ReplayWriter *writer) {
+    if (writer == NULL) return;
+    if (writer->runLength > 0) ReplayWriteRun(writer);
+    writer->buffer[writer->bufferUsed++] = 0; // Fim
+    ReplayFlushBuffer(writer);
+
+    unsigned char numTicks[4];
+    ReplayPutU32(numTicks, writer->numTicks);
+    fseek(writer->file, 14, SEEK_SET);
+    fwrite(numTicks, 1, 4, writer->file);
+    fclose(writer->file);
+    free(writer);
+}
+
+//------------------------------------------------------------------------------------
+// Reprodução
+//------------------------------------------------------------------------------------
+ReplayReader *ReplayOpenReader(const char *fileName) {
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return NULL;
+
+    unsigned char header[replayHeaderSize];
+    if (fread(header, 1, replayHeaderSize, file) != replayHeaderSize || memcmp(header, "N30R", 4) != 0 || header[4] != replayVersion) {
+        fclose(file);
+        return NULL;
+    }
+
+    ReplayReader *reader = (ReplayReader *)calloc(1, sizeof(ReplayReader));
+    reader->file = file;
+    reader->seed = (uint64_t)ReplayGetU32(header + 6) | ((uint64_t)ReplayGetU32(header + 10) << 32);
+    reader->numTicks = ReplayGetU32(header + 14);
+    return reader;
+}
+
+// Retorna -1 no fim do arquivo
+int ReplayReadByte(ReplayReader *reader) {
+    if (reader->bufferPos == reader->bufferUsed) {
+        reader->bufferUsed = fread(reader->buffer, 1, replayBufferSize, reader->file);
+        reader->bufferPos = 0;
+        if (reader->bufferUsed <= 0) return -1;
+    }
+    return reader->buffer[reader->bufferPos++];
+}
+
+// Entrada do próximo tick. Retorna false quando o replay acaba
+bool ReplayReadTick(ReplayReader *reader, InputFrame *input) {
+    if (reader->finished) return false;
+
+    if (reader->runLeft == 0) {
+        uint32_t runLength = 0;
+        int shift = 0, byte;
+        do {
+            byte = ReplayReadByte(reader);
+            if (byte < 0) break;
+            runLength |= (uint32_t)(byte & 0x7F) << shift;
+            shift += 7;
+        } while ((byte & 0x80) && shift < 32);
+        int down = ReplayReadByte(reader);
+        int pressed = ReplayReadByte(reader);
+
+        if (runLength == 0 || byte < 0 || down < 0 || pressed < 0) {
+            reader->finished = true;
+            return false;
+        }
+        reader->current = (InputFrame) {(unsigned char)down, (unsigned char)pressed};
+        reader->runLeft = runLength;
+    }
+
+    reader->runLeft--;
+    reader->tick++;
+    *input = reader->current;
+    return true;
+}
+
+void ReplayCloseReader(ReplayReader *reader) {
+    if (reader == NULL) return;
+    fclose(reader->file);
+    free(reader);
+}
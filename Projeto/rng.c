@@ -0,0 +1,87 @@
+#include <stdint.h>
+
+// Geradores de números aleatórios com seed (xoshiro128**)
+// Cada subsistema tem o seu stream, todos derivados da seed da partida. Assim a mesma seed gera
+// sempre o mesmo mundo, e a geração de chunks não disputa estado com a IA ou os efeitos.
+// A geração de chunks usa um gerador por chunk (RngDerive), que só depende da seed e do chunk:
+// o resultado é o mesmo em qualquer thread e em qualquer momento em que o chunk for planejado.
+enum RNG_STREAM {
+    RNG_WORLDGEN,   // Conteúdo dos chunks (props e inimigos), derivado por chunk
+    RNG_SCENERY,    // Arte dos backgrounds e plataformas do foreground, derivado por chunk
+    RNG_AI,         // Comportamento dos inimigos, derivado por inimigo (Enemy.aiRng)
+    RNG_EFFECTS,    // Drops, destruição de props e efeitos
+    NUM_RNG_STREAMS
+};
+
+typedef struct rng {
+    uint32_t s[4];
+} Rng;
+
+static Rng rngStreams[NUM_RNG_STREAMS];
+static uint64_t rngRunSeed;
+
+uint64_t SplitMix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void RngSeedStream(Rng *rng, uint64_t seed) {
+    uint64_t x = seed;
+    uint64_t a = SplitMix64(&x), b = SplitMix64(&x);
+    rng->s[0] = (uint32_t)a;
+    rng->s[1] = (uint32_t)(a >> 32);
+    rng->s[2] = (uint32_t)b;
+    rng->s[3] = (uint32_t)(b >> 32);
+}
+
+// Inicia todos os streams a partir da seed da partida
+void RngSeed(uint64_t runSeed) {
+    rngRunSeed = runSeed;
+    for (int i = 0; i < NUM_RNG_STREAMS; i++)
+        RngSeedStream(&rngStreams[i], runSeed ^ (0xD1B54A32D192ED03ull*(i + 1)));
+}
+
+static inline uint32_t RngRotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+uint32_t RngNext(Rng *rng) {
+    uint32_t *s = rng->s;
+    uint32_t result = RngRotl(s[1]*5, 7)*9;
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = RngRotl(s[3], 11);
+    return result;
+}
+
+// Mesmo contrato do GetRandomValue: valor entre min e max, os dois inclusos
+int RngRange(Rng *rng, int min, int max) {
+    if (min > max) {
+        int tmp = max;
+        max = min;
+        min = tmp;
+    }
+    uint32_t range = (uint32_t)(max - min) + 1;
+    if (range == 0) return (int)RngNext(rng); // Intervalo de 32 bits inteiro
+    return min + (int)(((uint64_t)RngNext(rng)*range) >> 32);
+}
+
+int RngValue(enum RNG_STREAM stream, int min, int max) {
+    return RngRange(&rngStreams[stream], min, max);
+}
+
+// Gerador independente para uma chave (ex: camada e índice do chunk) dentro de um stream.
+// Só lê a seed da partida, então pode ser usado fora da thread principal
+Rng RngDerive(enum RNG_STREAM stream, uint64_t key) {
+    Rng rng;
+    uint64_t x = rngRunSeed ^ (0xD1B54A32D192ED03ull*(stream + 1));
+    x ^= SplitMix64(&key);
+    RngSeedStream(&rng, x);
+    return rng;
+}
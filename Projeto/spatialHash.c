@@ -0,0 +1,188 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Spatial hash de grade uniforme (broadphase de colisão)
+// Cada objeto é registrado em todas as células que o seu retângulo toca. As células são espalhadas
+// em uma tabela de buckets por hash, então o mundo pode crescer para a direita indefinidamente.
+// As consultas retornam candidatos sem repetição, na ordem em que foram registrados (a mesma ordem do
+// laço sobre a pool que elas substituem); o teste exato (CheckCollision*) continua com quem chamou.
+// Objetos que se movem com a câmera (chão) ficam numa lista à parte e entram em todas as consultas.
+#define spatialCellSize 256.0f
+#define spatialNumBuckets 1024 // Potência de 2
+#define spatialMaxResults 512
+
+typedef struct spatialHash {
+    int bucketHead[spatialNumBuckets]; // Primeira entrada de cada bucket (-1 se vazio)
+    int *entryNext;    // Próxima entrada do mesmo bucket
+    int *entryItem;    // Índice do objeto na pool
+    int *entryCell;    // Célula (x, y) da entrada, para descartar colisões de hash
+    int numEntries;
+    int maxEntries;
+    int *itemStamp;    // Última consulta que retornou cada objeto (evita repetição), um array por thread de jobs
+    int *itemRank;     // Ordem de registro de cada objeto
+    int numRanked;
+    int *alwaysItems;  // Objetos retornados em toda consulta
+    int numAlways;
+    int version;       // Versão da pool no último build (-1: precisa reconstruir)
+    int maxItems;
+    int stamp[jobMaxThreads]; // Consultas podem rodar em paralelo (jobs), só a construção é da thread principal
+    Arena *arena;      // Dona dos arrays (a tabela cresce dentro dela)
+} SpatialHash;
+
+// Os arrays saem da arena da partida e voltam no ArenaReset
+void SpatialHashInit(SpatialHash *hash, int maxItems, Arena *arena) {
+    hash->arena = arena;
+    hash->maxItems = maxItems;
+    hash->maxEntries = 4*maxItems;
+    hash->numEntries = 0;
+    memset(hash->stamp, 0, sizeof(hash->stamp));
+    hash->entryNext = (int *)ArenaAlloc(arena, hash->maxEntries*sizeof(int));
+    hash->entryItem = (int *)ArenaAlloc(arena, hash->maxEntries*sizeof(int));
+    hash->entryCell = (int *)ArenaAlloc(arena, 2*hash->maxEntries*sizeof(int));
+    hash->itemStamp = (int *)ArenaAlloc(arena, jobMaxThreads*maxItems*sizeof(int));
+    hash->itemRank = (int *)ArenaAlloc(arena, maxItems*sizeof(int));
+    hash->numRanked = 0;
+    hash->alwaysItems = (int *)ArenaAlloc(arena, maxItems*sizeof(int));
+    hash->numAlways = 0;
+    hash->version = -1;
+    memset(hash->bucketHead, -1, sizeof(hash->bucketHead));
+}
+
+void SpatialHashClear(SpatialHash *hash) {
+    memset(hash->bucketHead, -1, sizeof(hash->bucketHead));
+    hash->numEntries = 0;
+    hash->numRanked = 0;
+    hash->numAlways = 0;
+}
+
+int SpatialCellCoord(float v) {
+    return (int)floorf(v/spatialCellSize);
+}
+
+int SpatialBucket(int cx, int cy) {
+    return (int)(((unsigned int)cx*73856093u ^ (unsigned int)cy*19349663u) & (spatialNumBuckets - 1));
+}
+
+void SpatialHashInsert(SpatialHash *hash, int item, Rectangle rect) {
+    int x0 = SpatialCellCoord(rect.x), x1 = SpatialCellCoord(rect.x + rect.width);
+    int y0 = SpatialCellCoord(rect.y), y1 = SpatialCellCoord(rect.y + rect.height);
+    hash->itemRank[item] = hash->numRanked++;
+
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            if (hash->numEntries == hash->maxEntries) { // Só cresce nos primeiros frames, depois fica estável
+                size_t size = hash->maxEntries*sizeof(int);
+                int *entryNext = (int *)ArenaGrow(hash->arena, hash->entryNext, size, 2*size);
+                int *entryItem = (int *)ArenaGrow(hash->arena, hash->entryItem, size, 2*size);
+                int *entryCell = (int *)ArenaGrow(hash->arena, hash->entryCell, 2*size, 4*size);
+                if (entryNext == NULL || entryItem == NULL || entryCell == NULL) return; // Arena cheia: o resto do objeto fica fora
+                hash->entryNext = entryNext;
+                hash->entryItem = entryItem;
+                hash->entryCell = entryCell;
+                hash->maxEntries *= 2;
+            }
+            int e = hash->numEntries++;
+            int b = SpatialBucket(cx, cy);
+            hash->entryItem[e] = item;
+            hash->entryCell[2*e] = cx;
+            hash->entryCell[2*e + 1] = cy;
+            hash->entryNext[e] = hash->bucketHead[b];
+            hash->bucketHead[b] = e;
+        }
+    }
+}
+
+void SpatialHashInsertAlways(SpatialHash *hash, int item) {
+    hash->itemRank[item] = hash->numRanked++;
+    hash->alwaysItems[hash->numAlways++] = item;
+}
+
+// Adiciona aos resultados os objetos da célula (cx, cy) que ainda não foram retornados nesta consulta
+int SpatialCollectCell(SpatialHash *hash, int cx, int cy, int *itemStamp, int stamp, int *results, int numResults, int maxResults) {
+    for (int e = hash->bucketHead[SpatialBucket(cx, cy)]; e != -1 && numResults < maxResults; e = hash->entryNext[e]) {
+        int item = hash->entryItem[e];
+        if (hash->entryCell[2*e] != cx || hash->entryCell[2*e + 1] != cy) continue;
+        if (itemStamp[item] == stamp) continue;
+        itemStamp[item] = stamp;
+        results[numResults++] = item;
+    }
+    return numResults;
+}
+
+int SpatialHashQueryRect(SpatialHash *hash, Rectangle rect, int *results, int maxResults) {
+    int numResults = 0;
+    int x0 = SpatialCellCoord(rect.x), x1 = SpatialCellCoord(rect.x + rect.width);
+    int y0 = SpatialCellCoord(rect.y), y1 = SpatialCellCoord(rect.y + rect.height);
+    int *itemStamp = hash->itemStamp + jobThreadIndex*hash->maxItems;
+    int stamp = ++hash->stamp[jobThreadIndex];
+
+    for (int cy = y0; cy <= y1; cy++)
+        for (int cx = x0; cx <= x1; cx++)
+            numResults = SpatialCollectCell(hash, cx, cy, itemStamp, stamp, results, numResults, maxResults);
+    for (int i = 0; i < hash->numAlways && numResults < maxResults; i++)
+        results[numResults++] = hash->alwaysItems[i];
+
+    // Ordenar pela ordem de registro (insertion sort, são poucos candidatos)
+    for (int i = 1; i < numResults; i++) {
+        int item = results[i];
+        int j = i - 1;
+        while (j >= 0 && hash->itemRank[results[j]] > hash->itemRank[item]) {
+            results[j + 1] = results[j];
+            j--;
+        }
+        results[j + 1] = item;
+    }
+    return numResults;
+}
+
+int SpatialHashQueryCircle(SpatialHash *hash, Vector2 center, float radius, int *results, int maxResults) {
+    return SpatialHashQueryRect(hash, (Rectangle) {center.x - radius, center.y - radius, 2*radius, 2*radius}, results, maxResults);
+}
+
+// Percorre as células cortadas pelo segmento (DDA), então os candidatos saem na ordem do raio
+// (os objetos da lista "always" vêm primeiro)
+int SpatialHashQueryRay(SpatialHash *hash, Vector2 origin, Vector2 direction, float length, int *results, int maxResults) {
+    int numResults = 0;
+    float dirLen = sqrtf(direction.x*direction.x + direction.y*direction.y);
+    if (dirLen == 0) return 0;
+    float dx = direction.x/dirLen, dy = direction.y/dirLen;
+
+    int cx = SpatialCellCoord(origin.x), cy = SpatialCellCoord(origin.y);
+    int endX = SpatialCellCoord(origin.x + dx*length), endY = SpatialCellCoord(origin.y + dy*length);
+    int stepX = (dx > 0 ? 1 : -1), stepY = (dy > 0 ? 1 : -1);
+    float tDeltaX = (dx != 0 ? fabsf(spatialCellSize/dx) : INFINITY);
+    float tDeltaY = (dy != 0 ? fabsf(spatialCellSize/dy) : INFINITY);
+    float nextX = (dx > 0 ? (cx + 1)*spatialCellSize : cx*spatialCellSize);
+    float nextY = (dy > 0 ? (cy + 1)*spatialCellSize : cy*spatialCellSize);
+    float tMaxX = (dx != 0 ? (nextX - origin.x)/dx : INFINITY);
+    float tMaxY = (dy != 0 ? (nextY - origin.y)/dy : INFINITY);
+    int *itemStamp = hash->itemStamp + jobThreadIndex*hash->maxItems;
+    int stamp = ++hash->stamp[jobThreadIndex];
+
+    for (int i = 0; i < hash->numAlways && numResults < maxResults; i++) {
+        results[numResults++] = hash->alwaysItems[i];
+        itemStamp[hash->alwaysItems[i]] = stamp;
+    }
+
+    while (1) {
+        numResults = SpatialCollectCell(hash, cx, cy, itemStamp, stamp, results, numResults, maxResults);
+        if ((cx == endX && cy == endY) || numResults == maxResults) break;
+        if (tMaxX < tMaxY) {
+            if (tMaxX > length) break;
+            tMaxX += tDeltaX;
+            cx += stepX;
+        } else {
+            if (tMaxY > length) break;
+            tMaxY += tDeltaY;
+            cy += stepY;
+        }
+    }
+    return numResults;
+}
+
+// Retângulo que cobre a caixa agora e depois de andar velocity*delta (consulta para colisões com a posição futura)
+Rectangle SpatialSweptRect(Rectangle rect, Vector2 velocity, float delta) {
+    float dx = velocity.x*delta, dy = velocity.y*delta;
+    return (Rectangle) {rect.x + fminf(dx, 0), rect.y + fminf(dy, 0), rect.width + fabsf(dx), rect.height + fabsf(dy)};
+}
@@ -0,0 +1,145 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Batch de sprites do mundo
+// As funções de desenho do mundo não desenham na hora: cada sprite vira um comando com camada e textura.
+// No fim do DrawWorld os comandos são ordenados por camada e, dentro da camada, por textura (counting sort
+// estável, a ordem de envio é mantida entre sprites da mesma camada e textura) e enviados em sequência.
+// O batch interno do raylib junta quads seguidos com a mesma textura numa única chamada de desenho, então
+// o número de chamadas passa a depender de quantas texturas cada camada usa e não de quantos objetos existem.
+#define spriteBatchCapacity 65536
+#define spriteBatchMaxGroups 64 // Pares (camada, textura) diferentes num frame
+
+// Ordem de desenho, de trás para frente
+enum SPRITE_LAYER {
+    LAYER_FAR_BACKGROUND, LAYER_MIDDLEGROUND, LAYER_FOREGROUND, LAYER_GROUNDS, LAYER_PROPS,
+    LAYER_ENEMIES, LAYER_PROJECTILES, LAYER_PLAYER, LAYER_PARTICLES,
+    NUM_SPRITE_LAYERS
+};
+
+typedef struct spriteCommand {
+    Texture2D texture;
+    Rectangle source;
+    Rectangle dest;
+    Vector2 origin;
+    float rotation;
+    Color tint;
+    bool isFill; // Retângulo sólido (plataformas), sem textura
+} SpriteCommand;
+
+typedef struct spriteGroup {
+    int layer;
+    unsigned int textureId; // 0 para retângulos sólidos
+    bool isFill;
+    int count;
+    int first; // Início do grupo na ordem final
+} SpriteGroup;
+
+typedef struct spriteBatch {
+    SpriteCommand commands[spriteBatchCapacity];
+    unsigned char commandGroup[spriteBatchCapacity];
+    int order[spriteBatchCapacity]; // Índices dos comandos já ordenados
+    int numCommands;
+    SpriteGroup groups[spriteBatchMaxGroups];
+    int numGroups;
+    int numDropped; // Sprites descartados por falta de espaço no frame
+    // Estatísticas do último flush
+    int lastNumSprites;
+    int lastNumBatches; // Trocas de textura (cada uma fecha um batch do raylib)
+    int lastNumDropped;
+} SpriteBatch;
+
+static SpriteBatch spriteBatch;
+
+void SpriteBatchBegin(void) {
+    spriteBatch.numCommands = 0;
+    spriteBatch.numGroups = 0;
+    spriteBatch.numDropped = 0;
+}
+
+int SpriteBatchGroup(int layer, unsigned int textureId, bool isFill) {
+    static int lastGroup = 0; // Sprites seguidos costumam ser do mesmo grupo (ex: todas as partículas)
+    if (lastGroup < spriteBatch.numGroups) {
+        SpriteGroup *group = &spriteBatch.groups[lastGroup];
+        if (group->layer == layer && group->textureId == textureId && group->isFill == isFill) return lastGroup;
+    }
+    for (int g = 0; g < spriteBatch.numGroups; g++) {
+        SpriteGroup *group = &spriteBatch.groups[g];
+        if (group->layer == layer && group->textureId == textureId && group->isFill == isFill) return lastGroup = g;
+    }
+    if (spriteBatch.numGroups == spriteBatchMaxGroups) return -1;
+    spriteBatch.groups[spriteBatch.numGroups] = (SpriteGroup) {layer, textureId, isFill, 0, 0};
+    return lastGroup = spriteBatch.numGroups++;
+}
+
+void SpriteBatchPush(int layer, SpriteCommand command) {
+    int g = SpriteBatchGroup(layer, command.texture.id, command.isFill);
+    if (g == -1 || spriteBatch.numCommands == spriteBatchCapacity) {
+        spriteBatch.numDropped++;
+        return;
+    }
+    spriteBatch.commandGroup[spriteBatch.numCommands] = g;
+    spriteBatch.commands[spriteBatch.numCommands++] = command;
+    spriteBatch.groups[g].count++;
+}
+
+// Mesmos parâmetros do DrawTexturePro
+void SpriteBatchAdd(enum SPRITE_LAYER layer, Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint) {
+    SpriteBatchPush(layer, (SpriteCommand) {texture, source, dest, origin, rotation, tint, false});
+}
+
+void SpriteBatchAddRect(enum SPRITE_LAYER layer, Rectangle rect, Color color) {
+    SpriteBatchPush(layer, (SpriteCommand) {{0}, {0}, rect, {0, 0}, 0, color, true});
+}
+
+int SpriteBatchCompareGroups(const void *a, const void *b) {
+    const SpriteGroup *x = (const SpriteGroup *)a, *y = (const SpriteGroup *)b;
+    if (x->layer != y->layer) return x->layer - y->layer;
+    if (x->isFill != y->isFill) return (int)x->isFill - (int)y->isFill;
+    return (x->textureId > y->textureId) - (x->textureId < y->textureId);
+}
+
+// Ordena e desenha tudo que foi enviado desde o SpriteBatchBegin
+void SpriteBatchFlush(void) {
+    // Ordem dos grupos: camada, depois textura
+    int rank[spriteBatchMaxGroups];
+    SpriteGroup sorted[spriteBatchMaxGroups];
+    memcpy(sorted, spriteBatch.groups, spriteBatch.numGroups*sizeof(SpriteGroup));
+    qsort(sorted, spriteBatch.numGroups, sizeof(SpriteGroup), SpriteBatchCompareGroups);
+    int first = 0;
+    for (int s = 0; s < spriteBatch.numGroups; s++) {
+        int g = SpriteBatchGroup(sorted[s].layer, sorted[s].textureId, sorted[s].isFill);
+        spriteBatch.groups[g].first = first;
+        rank[s] = g;
+        first += sorted[s].count;
+    }
+
+    // Counting sort: cada comando vai para a próxima posição livre do seu grupo
+    int next[spriteBatchMaxGroups];
+    for (int g = 0; g < spriteBatch.numGroups; g++) next[g] = spriteBatch.groups[g].first;
+    for (int i = 0; i < spriteBatch.numCommands; i++)
+        spriteBatch.order[next[spriteBatch.commandGroup[i]]++] = i;
+
+    for (int s = 0; s < spriteBatch.numGroups; s++) {
+        SpriteGroup *group = &spriteBatch.groups[rank[s]];
+        for (int k = group->first; k < group->first + group->count; k++) {
+            SpriteCommand *command = &spriteBatch.commands[spriteBatch.order[k]];
+            if (command->isFill)
+                DrawRectangleRec(command->dest, command->tint);
+            else
+                DrawTexturePro(command->texture, command->source, command->dest, command->origin, command->rotation, command->tint);
+        }
+    }
+
+    // Grupos seguidos com a mesma textura (ex: camadas diferentes do miscAtlas) continuam no mesmo batch
+    int numBatches = 0;
+    for (int s = 0; s < spriteBatch.numGroups; s++) {
+        if (s == 0 || sorted[s].textureId != sorted[s - 1].textureId || sorted[s].isFill != sorted[s - 1].isFill) numBatches++;
+    }
+    spriteBatch.lastNumSprites = spriteBatch.numCommands;
+    spriteBatch.lastNumBatches = numBatches;
+    spriteBatch.lastNumDropped = spriteBatch.numDropped;
+    spriteBatch.numCommands = 0;
+    spriteBatch.numGroups = 0;
+}
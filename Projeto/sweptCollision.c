@@ -0,0 +1,104 @@
+#include <math.h>
+#include <stdbool.h>
+
+// Colisão contínua (varrida)
+// Testes de um objeto que se move em linha reta por motion durante o passo contra um objeto parado.
+// Retornam o primeiro instante de contato t em [0, 1] (fração do movimento) e a normal da superfície
+// atingida, então balas e granadas não atravessam objetos finos mesmo em passos longos.
+// Contato já no início do movimento retorna t = 0.
+
+// Segmento origin -> origin + motion contra o retângulo (slabs)
+bool SweepSegmentRect(Vector2 origin, Vector2 motion, Rectangle rect, float *tHit, Vector2 *normal) {
+    float tEnter = 0, tExit = 1;
+    Vector2 n = {0, 0};
+    float o[2] = {origin.x, origin.y}, d[2] = {motion.x, motion.y};
+    float lo[2] = {rect.x, rect.y}, hi[2] = {rect.x + rect.width, rect.y + rect.height};
+    for (int axis = 0; axis < 2; axis++) {
+        if (d[axis] == 0) {
+            if (o[axis] < lo[axis] || o[axis] > hi[axis]) return false; // Paralelo e fora
+            continue;
+        }
+        float t0 = (lo[axis] - o[axis])/d[axis], t1 = (hi[axis] - o[axis])/d[axis];
+        float side = -1; // Entrou pela face de menor coordenada
+        if (t0 > t1) {
+            float tmp = t0; t0 = t1; t1 = tmp;
+            side = 1;
+        }
+        if (t0 > tEnter) {
+            tEnter = t0;
+            n = (axis == 0 ? (Vector2) {side, 0} : (Vector2) {0, side});
+        }
+        if (t1 < tExit) tExit = t1;
+        if (tEnter > tExit) return false;
+    }
+    *tHit = tEnter;
+    *normal = n;
+    return true;
+}
+
+// Segmento contra círculo
+bool SweepSegmentCircle(Vector2 origin, Vector2 motion, Vector2 center, float radius, float *tHit) {
+    float mx = origin.x - center.x, my = origin.y - center.y;
+    float c = mx*mx + my*my - radius*radius;
+    if (c <= 0) { // Começa dentro
+        *tHit = 0;
+        return true;
+    }
+    float a = motion.x*motion.x + motion.y*motion.y;
+    float b = mx*motion.x + my*motion.y;
+    if (a == 0 || b >= 0) return false; // Parado ou se afastando
+    float discr = b*b - a*c;
+    if (discr < 0) return false;
+    float t = (-b - sqrtf(discr))/a;
+    if (t > 1) return false;
+    *tHit = t;
+    return true;
+}
+
+// Retângulo box andando motion contra o retângulo target (segmento contra o target aumentado pelo box)
+bool SweepRectRect(Rectangle box, Vector2 motion, Rectangle target, float *tHit, Vector2 *normal) {
+    Rectangle expanded = {target.x - box.width, target.y - box.height, target.width + box.width, target.height + box.height};
+    return SweepSegmentRect((Vector2) {box.x, box.y}, motion, expanded, tHit, normal);
+}
+
+// Círculo andando motion contra o retângulo: segmento contra o retângulo com os cantos arredondados pelo raio
+bool SweepCircleRect(Vector2 center, float radius, Vector2 motion, Rectangle rect, float *tHit, Vector2 *normal) {
+    // Já encostado: normal do ponto mais próximo do retângulo até o centro
+    float closestX = fmaxf(rect.x, fminf(center.x, rect.x + rect.width));
+    float closestY = fmaxf(rect.y, fminf(center.y, rect.y + rect.height));
+    float dx = center.x - closestX, dy = center.y - closestY;
+    if (dx*dx + dy*dy <= radius*radius) {
+        if (dx == 0 && dy == 0) { // Centro dentro do retângulo: sai pela face mais próxima
+            float left = center.x - rect.x, right = rect.x + rect.width - center.x;
+            float top = center.y - rect.y, bottom = rect.y + rect.height - center.y;
+            float minX = fminf(left, right), minY = fminf(top, bottom);
+            *normal = (minX < minY ? (Vector2) {left < right ? -1 : 1, 0} : (Vector2) {0, top < bottom ? -1 : 1});
+        } else {
+            float len = sqrtf(dx*dx + dy*dy);
+            *normal = (Vector2) {dx/len, dy/len};
+        }
+        *tHit = 0;
+        return true;
+    }
+
+    Rectangle expanded = {rect.x - radius, rect.y - radius, rect.width + 2*radius, rect.height + 2*radius};
+    float t;
+    Vector2 n;
+    if (!SweepSegmentRect(center, motion, expanded, &t, &n)) return false;
+    float px = center.x + motion.x*t, py = center.y + motion.y*t;
+    bool insideX = (px >= rect.x && px <= rect.x + rect.width);
+    bool insideY = (py >= rect.y && py <= rect.y + rect.height);
+    if (insideX || insideY) { // Face
+        *tHit = t;
+        *normal = n;
+        return true;
+    }
+    // Canto: círculo de raio radius no vértice mais próximo do ponto de entrada
+    Vector2 corner = {px < rect.x ? rect.x : rect.x + rect.width, py < rect.y ? rect.y : rect.y + rect.height};
+    if (!SweepSegmentCircle(center, motion, corner, radius, &t)) return false;
+    px = center.x + motion.x*t;
+    py = center.y + motion.y*t;
+    *tHit = t;
+    *normal = (Vector2) {(px - corner.x)/radius, (py - corner.y)/radius};
+    return true;
+}